@@ -0,0 +1,285 @@
+#include "registry.h"
+#include "polynomial.h"
+#include "texteditor.h"
+#include "uno.h"
+#include "rng.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Multi-threaded stress test of the object registry (registry.h).
+//
+// 1. Raw registry: every thread mixes lookups of random live handles with
+//    replacing random objects (insert + remove), against the same workload
+//    on a std::map behind a mutex, the layout the modules used before.
+//    Every lookup checks that it found the object its handle names.
+// 2. Modules: every thread creates, uses and destroys Polynomials,
+//    TextEditors and UNOGames, and the results must match a single thread.
+// 3. Reclamation: once the threads are done every removed object is freed.
+//
+// Usage:
+//   bench_registry [max threads] [ops per thread] [lookup percent]
+
+typedef std::chrono::steady_clock Clock;
+
+static const int tableSize = 1 << 16;
+
+// Registered object; key is the handle it was registered under
+struct Payload {
+    static std::atomic<long long> live;
+    uint64_t key;
+
+    Payload() : key(0) {
+        live++;
+    }
+
+    ~Payload() {
+        key = 0;
+        live--;
+    }
+};
+
+std::atomic<long long> Payload::live(0);
+
+// What the modules used before: a map and a mutex around every access
+class LockedRegistry {
+public:
+    ~LockedRegistry() {
+        for (auto& entry : objects) {
+            delete entry.second;
+        }
+    }
+
+    uint64_t insert(Payload* object) {
+        std::lock_guard<std::mutex> guard(lock);
+        uint64_t handle = nextHandle++;
+        objects[handle] = object;
+        return handle;
+    }
+
+    // Copies the key out under the lock, since the object may go any time
+    bool findKey(uint64_t handle, uint64_t& key) {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = objects.find(handle);
+        if (it == objects.end()) {
+            return false;
+        }
+        key = it->second->key;
+        return true;
+    }
+
+    bool remove(uint64_t handle) {
+        Payload* object;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            auto it = objects.find(handle);
+            if (it == objects.end()) {
+                return false;
+            }
+            object = it->second;
+            objects.erase(it);
+        }
+        delete object;
+        return true;
+    }
+
+private:
+    std::mutex lock;
+    std::map<uint64_t, Payload*> objects;
+    uint64_t nextHandle = 1;
+};
+
+struct Counts {
+    long long found;
+    long long errors;
+};
+
+static void lockFreeWorker(ObjectRegistry<Payload>& registry, std::vector<std::atomic<uint64_t>>& table,
+                           int ops, int lookupPercent, uint64_t seed, Counts& counts) {
+    Xoshiro256 rng(seed);
+    Counts local = {0, 0};    // Kept off the shared cache lines until the end
+    for (int i = 0; i < ops; i++) {
+        uint64_t r = rng();
+        std::atomic<uint64_t>& cell = table[r % tableSize];
+        if (static_cast<int>((r >> 32) % 100) < lookupPercent) {
+            uint64_t handle = cell.load(std::memory_order_acquire);
+            ReadGuard guard;
+            Payload* object = registry.find(handle);
+            if (object) {
+                local.found++;
+                local.errors += object->key != handle;
+            }
+        } else {
+            Payload* object = new Payload();
+            uint64_t handle = registry.insert(object);
+            object->key = handle;
+            uint64_t old = cell.exchange(handle);
+            local.errors += !registry.remove(old);
+        }
+    }
+    counts = local;
+}
+
+static void lockedWorker(LockedRegistry& registry, std::vector<std::atomic<uint64_t>>& table, int ops,
+                         int lookupPercent, uint64_t seed, Counts& counts) {
+    Xoshiro256 rng(seed);
+    Counts local = {0, 0};    // Kept off the shared cache lines until the end
+    for (int i = 0; i < ops; i++) {
+        uint64_t r = rng();
+        std::atomic<uint64_t>& cell = table[r % tableSize];
+        if (static_cast<int>((r >> 32) % 100) < lookupPercent) {
+            uint64_t handle = cell.load(std::memory_order_acquire);
+            uint64_t key;
+            if (registry.findKey(handle, key)) {
+                local.found++;
+                local.errors += key != handle;
+            }
+        } else {
+            Payload* object = new Payload();
+            uint64_t handle = registry.insert(object);
+            object->key = handle;
+            uint64_t old = cell.exchange(handle);
+            local.errors += !registry.remove(old);
+        }
+    }
+    counts = local;
+}
+
+// Run worker on numThreads threads; returns operations per second
+template <class Registry, class Worker>
+static double runRegistry(Registry& registry, Worker worker, int numThreads, int ops,
+                          int lookupPercent, long long& errors) {
+    std::vector<std::atomic<uint64_t>> table(tableSize);
+    for (int i = 0; i < tableSize; i++) {
+        Payload* object = new Payload();
+        uint64_t handle = registry.insert(object);
+        object->key = handle;
+        table[i].store(handle);
+    }
+
+    std::vector<Counts> counts(numThreads, Counts{0, 0});
+    std::vector<std::thread> threads;
+    Clock::time_point start = Clock::now();
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back(worker, std::ref(registry), std::ref(table), ops, lookupPercent,
+                             static_cast<uint64_t>(t + 1), std::ref(counts[t]));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (int i = 0; i < tableSize; i++) {
+        registry.remove(table[i].load());
+    }
+    for (const Counts& c : counts) {
+        errors += c.errors;
+    }
+    return static_cast<double>(ops) * numThreads / seconds;
+}
+
+// One round of module work; the checksum depends only on round
+static uint64_t moduleRound(int round) {
+    uint64_t sum = 0;
+
+    Polynomial p;
+    for (int k = 0; k < 8; k++) {
+        p.insertTerm((round + k) % 7 - 3, k);
+    }
+    Polynomial q = p.multiply(p.derivative());
+    sum += std::hash<std::string>()(q.toString());
+
+    TextEditor editor;
+    for (int k = 0; k < 64; k++) {
+        editor.insertChar(static_cast<char>('a' + (round + k) % 26));
+        if (k % 5 == 4) editor.moveLeft();
+        if (k % 9 == 8) editor.deleteChar();
+    }
+    sum = sum * 31 + std::hash<std::string>()(editor.getTextWithCursor());
+
+    UNOGame game(2 + round % 3);
+    game.reset(SplitMix64(round)(), 2 + round % 3);
+    while (!game.isGameOver() && game.getTurnCount() < 2000) {
+        game.playTurn();
+    }
+    sum = sum * 31 + game.getTurnCount();
+    return sum;
+}
+
+static double runModules(int numThreads, int rounds, const std::vector<uint64_t>& expected,
+                         long long& errors) {
+    std::vector<long long> mismatches(numThreads, 0);
+    std::vector<std::thread> threads;
+    Clock::time_point start = Clock::now();
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back([&, t]() {
+            for (int r = 0; r < rounds; r++) {
+                mismatches[t] += moduleRound(r) != expected[r];
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    for (long long m : mismatches) {
+        errors += m;
+    }
+    return static_cast<double>(rounds) * numThreads / seconds;
+}
+
+int main(int argc, char** argv) {
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : std::max(4, hardware);
+    int ops = argc > 2 ? std::atoi(argv[2]) : 1000000;
+    int lookupPercent = argc > 3 ? std::atoi(argv[3]) : 90;
+    int rounds = std::max(1, ops / 500);
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) {
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(maxThreads);
+
+    std::printf("%d hardware threads, %d ops per thread, %d%% lookups\n", hardware, ops, lookupPercent);
+    std::printf("%8s %16s %16s %10s\n", "threads", "registry ops/s", "map+mutex ops/s", "ratio");
+    long long errors = 0;
+    double baseFree = 0, baseLocked = 0;
+    for (int threads : threadCounts) {
+        ObjectRegistry<Payload> registry;
+        LockedRegistry locked;
+        double lockFree = runRegistry(registry, lockFreeWorker, threads, ops, lookupPercent, errors);
+        double mutex = runRegistry(locked, lockedWorker, threads, ops, lookupPercent, errors);
+        if (threads == 1) {
+            baseFree = lockFree;
+            baseLocked = mutex;
+        }
+        std::printf("%8d %16.0f %16.0f %9.2fx   scaling %.2fx vs %.2fx\n", threads, lockFree, mutex,
+                    lockFree / mutex, lockFree / baseFree, mutex / baseLocked);
+        EpochDomain::instance().collect();
+    }
+
+    std::vector<uint64_t> expected(rounds);
+    for (int r = 0; r < rounds; r++) {
+        expected[r] = moduleRound(r);
+    }
+    std::printf("\n%8s %16s\n", "threads", "module rounds/s");
+    for (int threads : threadCounts) {
+        double rate = runModules(threads, rounds, expected, errors);
+        std::printf("%8d %16.0f\n", threads, rate);
+    }
+
+    EpochDomain::instance().collect();
+    long long leaked = Payload::live.load();
+    std::printf("\nlookup/result errors: %lld\n", errors);
+    std::printf("unreclaimed objects:  %lld\n", leaked);
+    return errors == 0 && leaked == 0 ? 0 : 1;
+}
@@ -0,0 +1,366 @@
+#include "texteditor.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Edit-trace replay benchmark for TextEditor.
+//
+// Trace file format (text, one command per line):
+//   i <text>   type each character of <text> (\n, \t and \\ are escaped)
+//   d <n>      press backspace n times
+//   l <n>      move the cursor left n times
+//   r <n>      move the cursor right n times
+//   # ...      comment
+// Every character typed and every repetition counts as one operation,
+// matching one call on the TextEditor interface.
+//
+// Every backend is replayed in a forked child process, so its peak RSS is
+// its own and not left over from the backend before it.
+//
+// Usage:
+//   bench_texteditor <trace>                      replay a recorded trace
+//   bench_texteditor <trace> --journal <path>     replay with and without an edit journal
+//   bench_texteditor --generate <trace> <ops> [seed]
+//                                                 write a synthetic typing session
+
+// Allocation counters (every operator new in the process goes through here)
+static size_t allocCount = 0;
+static size_t allocBytes = 0;
+
+void* operator new(size_t size) {
+    allocCount++;
+    allocBytes += size;
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+// A single replayable editor operation
+struct TraceOp {
+    enum Kind : char { INSERT = 'i', DELETE = 'd', LEFT = 'l', RIGHT = 'r' };
+
+    Kind kind;
+    char c; // character for INSERT
+};
+
+static std::string unescape(const std::string& s) {
+    std::string out;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '\\' && i + 1 < s.size()) {
+            char e = s[++i];
+            if (e == 'n') out += '\n';
+            else if (e == 't') out += '\t';
+            else out += e;
+        } else {
+            out += s[i];
+        }
+    }
+    return out;
+}
+
+static std::string escape(char c) {
+    if (c == '\n') return "\\n";
+    if (c == '\t') return "\\t";
+    if (c == '\\') return "\\\\";
+    return std::string(1, c);
+}
+
+// Parse a trace file into a flat list of operations
+static bool loadTrace(const std::string& path, std::vector<TraceOp>& ops) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "cannot open trace " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (line.empty() || line[0] == '#') continue;
+
+        char kind = line[0];
+        std::string arg = line.size() > 2 ? line.substr(2) : "";
+
+        if (kind == TraceOp::INSERT) {
+            for (char c : unescape(arg)) {
+                ops.push_back({TraceOp::INSERT, c});
+            }
+        } else if (kind == TraceOp::DELETE || kind == TraceOp::LEFT || kind == TraceOp::RIGHT) {
+            long n = arg.empty() ? 1 : std::strtol(arg.c_str(), nullptr, 10);
+            for (long k = 0; k < n; k++) {
+                ops.push_back({static_cast<TraceOp::Kind>(kind), 0});
+            }
+        } else {
+            std::cerr << path << ":" << lineNo << ": unknown command '" << kind << "'" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Write a synthetic typing session: mostly typing at the cursor, with
+// backspace bursts and occasional cursor jumps back into the text
+static bool generateTrace(const std::string& path, size_t numOps, unsigned seed) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "cannot write trace " << path << std::endl;
+        return false;
+    }
+
+    static const char words[] = "the quick brown fox jumps over a lazy dog while editors replay traces ";
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pick(0, 99);
+
+    out << "# synthetic typing session, seed " << seed << "\n";
+
+    size_t ops = 0;
+    long length = 0;   // characters in the document
+    long cursor = 0;   // characters before the cursor
+    size_t wordPos = 0;
+
+    while (ops < numOps) {
+        int roll = pick(rng);
+
+        if (roll < 80) {
+            // Type a short run of characters
+            int run = 1 + pick(rng) % 12;
+            std::string text;
+            for (int k = 0; k < run; k++) {
+                char c = words[wordPos++ % (sizeof(words) - 1)];
+                if (pick(rng) < 2) c = '\n';
+                text += escape(c);
+            }
+            out << "i " << text << "\n";
+            ops += run;
+            length += run;
+            cursor += run;
+        } else if (roll < 92) {
+            // Backspace burst
+            long n = std::min<long>(1 + pick(rng) % 6, cursor);
+            if (n == 0) continue;
+            out << "d " << n << "\n";
+            ops += n;
+            length -= n;
+            cursor -= n;
+        } else if (roll < 97) {
+            // Move back into the text
+            long n = std::min<long>(1 + pick(rng) % 40, cursor);
+            if (n == 0) continue;
+            out << "l " << n << "\n";
+            ops += n;
+            cursor -= n;
+        } else {
+            // Move forward towards the end
+            long n = std::min<long>(1 + pick(rng) % 40, length - cursor);
+            if (n == 0) continue;
+            out << "r " << n << "\n";
+            ops += n;
+            cursor += n;
+        }
+    }
+    return true;
+}
+
+// Resident set size right now, from /proc/self/statm (0 if unavailable)
+static long currentRssKb() {
+    std::ifstream statm("/proc/self/statm");
+    long pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) {
+        return 0;
+    }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Highest resident set size of this process so far
+static long peakRssKb() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return usage.ru_maxrss;
+}
+
+template <class Editor>
+static void apply(Editor& ed, const TraceOp& op) {
+    switch (op.kind) {
+        case TraceOp::INSERT: ed.insertChar(op.c); break;
+        case TraceOp::DELETE: ed.deleteChar(); break;
+        case TraceOp::LEFT: ed.moveLeft(); break;
+        case TraceOp::RIGHT: ed.moveRight(); break;
+    }
+}
+
+template <class Editor>
+static bool openFreshJournal(Editor& ed, const std::string& journalPath) {
+    if (journalPath.empty()) {
+        return true;
+    }
+    // Start from an empty journal so every run replays the same work
+    std::remove(journalPath.c_str());
+    std::remove((journalPath + ".ckpt").c_str());
+    if (!ed.openJournal(journalPath)) {
+        std::cerr << "cannot open journal " << journalPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Replay ops against any editor type with the TextEditor interface, so
+// alternative storage backends can be timed on the same workload. The
+// trace is replayed twice on fresh editors: once timed as a whole for
+// throughput, allocations and peak memory, and once with every op timed for
+// the latency percentiles, so clock reads never count against ops/s.
+// Returns operations per second.
+template <class Editor>
+static double replay(const std::vector<TraceOp>& ops, const std::string& name,
+                     const std::string& journalPath = "") {
+    typedef std::chrono::steady_clock Clock;
+
+    double seconds;
+    size_t allocs, bytes;
+    long rssBefore, rssPeak;
+    {
+        rssBefore = currentRssKb();
+        Editor ed;
+        if (!openFreshJournal(ed, journalPath)) {
+            return 0;
+        }
+        size_t allocsBefore = allocCount;
+        size_t bytesBefore = allocBytes;
+
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < ops.size(); i++) {
+            apply(ed, ops[i]);
+        }
+        if (!journalPath.empty()) {
+            ed.closeJournal();
+        }
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        allocs = allocCount - allocsBefore;
+        bytes = allocBytes - bytesBefore;
+        rssPeak = peakRssKb();
+    }
+
+    std::vector<uint32_t> latencies(ops.size());
+    {
+        Editor ed;
+        if (!openFreshJournal(ed, journalPath)) {
+            return 0;
+        }
+        for (size_t i = 0; i < ops.size(); i++) {
+            Clock::time_point t0 = Clock::now();
+            apply(ed, ops[i]);
+            Clock::time_point t1 = Clock::now();
+            latencies[i] = static_cast<uint32_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        }
+        if (!journalPath.empty()) {
+            ed.closeJournal();
+        }
+    }
+
+    uint32_t p50 = 0, p99 = 0;
+    if (!latencies.empty()) {
+        size_t i50 = latencies.size() / 2;
+        size_t i99 = latencies.size() * 99 / 100;
+        std::nth_element(latencies.begin(), latencies.begin() + i50, latencies.end());
+        p50 = latencies[i50];
+        std::nth_element(latencies.begin(), latencies.begin() + i99, latencies.end());
+        p99 = latencies[i99];
+    }
+
+    std::printf("backend:      %s\n", name.c_str());
+    std::printf("operations:   %zu\n", ops.size());
+    std::printf("elapsed:      %.3f s\n", seconds);
+    std::printf("throughput:   %.0f ops/s\n", seconds > 0 ? ops.size() / seconds : 0.0);
+    std::printf("latency p50:  %u ns\n", p50);
+    std::printf("latency p99:  %u ns\n", p99);
+    std::printf("allocations:  %zu (%zu bytes)\n", allocs, bytes);
+    std::printf("peak RSS:     %ld KB (%ld KB before the replay)\n", rssPeak, rssBefore);
+    return seconds > 0 ? ops.size() / seconds : 0.0;
+}
+
+// Run replay in a child process and return its ops/s (0 on failure)
+template <class Editor>
+static double replayInChild(const std::vector<TraceOp>& ops, const std::string& name,
+                            const std::string& journalPath = "") {
+    int fds[2];
+    std::fflush(stdout);
+    if (pipe(fds) != 0) {
+        std::cerr << "pipe failed" << std::endl;
+        return 0;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "fork failed" << std::endl;
+        ::close(fds[0]);
+        ::close(fds[1]);
+        return 0;
+    }
+    if (pid == 0) {
+        ::close(fds[0]);
+        double rate = replay<Editor>(ops, name, journalPath);
+        std::fflush(stdout);
+        bool sent = write(fds[1], &rate, sizeof(rate)) == static_cast<ssize_t>(sizeof(rate));
+        _exit(sent ? 0 : 1);
+    }
+
+    ::close(fds[1]);
+    double rate = 0;
+    if (read(fds[0], &rate, sizeof(rate)) != static_cast<ssize_t>(sizeof(rate))) {
+        rate = 0;
+    }
+    ::close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return rate;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 4 && std::string(argv[1]) == "--generate") {
+        size_t numOps = std::strtoul(argv[3], nullptr, 10);
+        unsigned seed = argc >= 5 ? std::strtoul(argv[4], nullptr, 10) : 1234;
+        return generateTrace(argv[2], numOps, seed) ? 0 : 1;
+    }
+
+    bool journal = argc == 4 && std::string(argv[2]) == "--journal";
+    if (argc != 2 && !journal) {
+        std::cerr << "usage: " << argv[0] << " <trace> [--journal <path>]" << std::endl;
+        std::cerr << "       " << argv[0] << " --generate <trace> <ops> [seed]" << std::endl;
+        return 1;
+    }
+
+    std::vector<TraceOp> ops;
+    if (!loadTrace(argv[1], ops)) {
+        return 1;
+    }
+
+    double plain = replayInChild<TextEditor>(ops, "TextEditor (doubly linked list)");
+    if (journal) {
+        std::printf("\n");
+        double journaled = replayInChild<TextEditor>(ops, "TextEditor + edit journal", argv[3]);
+        std::printf("\njournal overhead: %.1f%% of throughput\n",
+                    plain > 0 ? 100.0 * (plain - journaled) / plain : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "uno.h"
+#include "unobatch.h"
+#include "rng.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Lockstep batch simulator vs the scalar engine: checks that both play
+// identical games, then compares turns per second.
+//
+// Usage:
+//   bench_unobatch [games] [players] [seed] [maxTurns]
+
+static int maxTurns = 2000;
+
+static bool sameState(const GameState& a, const GameState& b) {
+    for (int p = 0; p < a.numPlayers; p++) {
+        if (a.hands[p] != b.hands[p] || a.handDoubles[p] != b.handDoubles[p] ||
+            a.cardCounts[p] != b.cardCounts[p]) {
+            return false;
+        }
+    }
+    for (int i = a.drawIndex; i < UNOGame::deckCapacity; i++) {
+        if (a.deck[i] != b.deck[i]) return false;
+    }
+    return a.drawIndex == b.drawIndex && a.topCard == b.topCard &&
+           a.numPlayers == b.numPlayers && a.currentPlayer == b.currentPlayer &&
+           a.clockwise == b.clockwise;
+}
+
+int main(int argc, char** argv) {
+    int numGames = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int numPlayers = argc > 2 ? std::atoi(argv[2]) : 4;
+    uint64_t masterSeed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1234;
+    if (argc > 4) maxTurns = std::atoi(argv[4]);
+    typedef std::chrono::steady_clock Clock;
+
+    std::vector<uint64_t> seeds(numGames);
+    for (int i = 0; i < numGames; i++) {
+        seeds[i] = SplitMix64(masterSeed + i)();
+    }
+
+    // Scalar engine
+    std::vector<GameState> scalarEnd(numGames);
+    std::vector<int> scalarTurns(numGames);
+    std::vector<int> scalarWinner(numGames);
+    long long scalarTotal = 0;
+    UNOGame game(numPlayers);
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < numGames; i++) {
+        game.reset(seeds[i], numPlayers);
+        while (!game.isGameOver() && game.getTurnCount() < maxTurns) {
+            game.playTurn();
+        }
+        scalarTurns[i] = game.getTurnCount();
+        scalarWinner[i] = game.getWinner();
+        scalarTotal += scalarTurns[i];
+        scalarEnd[i] = game.saveState();
+    }
+    double scalarSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Dealing is the same scalar code on both sides; time it on its own
+    start = Clock::now();
+    for (int i = 0; i < numGames; i++) {
+        game.reset(seeds[i], numPlayers);
+    }
+    double scalarDealSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Lockstep batch
+    UNOBatch batch(numGames, numPlayers);
+    start = Clock::now();
+    batch.deal(seeds.data());
+    double dealSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    batch.run(maxTurns);
+    double batchSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    long long batchTotal = 0;
+    int mismatches = 0;
+    for (int i = 0; i < numGames; i++) {
+        batchTotal += batch.getTurnCount(i);
+        if (batch.getTurnCount(i) != scalarTurns[i] || batch.getWinner(i) != scalarWinner[i] ||
+            !sameState(batch.saveState(i), scalarEnd[i])) {
+            if (mismatches++ < 5) {
+                std::printf("game %d differs: turns %d vs %d, winner %d vs %d\n", i,
+                            batch.getTurnCount(i), scalarTurns[i], batch.getWinner(i), scalarWinner[i]);
+            }
+        }
+    }
+
+    std::printf("%d games, %d players\n", numGames, numPlayers);
+    std::printf("validation:   %s (%d mismatching games)\n", mismatches ? "FAILED" : "identical", mismatches);
+    std::printf("scalar:       %.0f turns/s (%.0f excluding the deal)\n", scalarTotal / scalarSeconds,
+                scalarTotal / (scalarSeconds - scalarDealSeconds));
+    std::printf("batch:        %.0f turns/s (%.0f excluding the deal)\n", batchTotal / batchSeconds,
+                batchTotal / (batchSeconds - dealSeconds));
+    return mismatches ? 1 : 0;
+}
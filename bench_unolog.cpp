@@ -0,0 +1,168 @@
+#include "uno.h"
+#include "unolog.h"
+#include "rng.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Cost of the binary event log compared with no logging and with calling
+// getState() every turn, plus a check that replaying the log rebuilds
+// every game exactly.
+//
+// Usage:
+//   bench_unolog [games] [players] [log file]
+
+static const int maxTurns = 2000;
+
+enum Mode { NONE, RING, FILE_SINK, STATE_STRING };
+
+static bool sameState(const GameState& a, const GameState& b) {
+    for (int p = 0; p < a.numPlayers; p++) {
+        if (a.hands[p] != b.hands[p] || a.handDoubles[p] != b.handDoubles[p] ||
+            a.cardCounts[p] != b.cardCounts[p]) {
+            return false;
+        }
+    }
+    for (int i = a.drawIndex; i < UNOGame::deckCapacity; i++) {
+        if (a.deck[i] != b.deck[i]) return false;
+    }
+    return a.drawIndex == b.drawIndex && a.topCard == b.topCard &&
+           a.numPlayers == b.numPlayers && a.currentPlayer == b.currentPlayer &&
+           a.clockwise == b.clockwise;
+}
+
+struct RunResult {
+    long long turns;
+    double seconds;
+    size_t bytes;
+};
+
+static RunResult run(Mode mode, int numGames, int numPlayers, uint64_t masterSeed,
+                     const std::string& path, std::vector<GameState>* finals) {
+    typedef std::chrono::steady_clock Clock;
+    std::vector<uint8_t> ringMemory(1 << 20);
+    std::vector<uint8_t> drained(ringMemory.size());
+    RingBufferSink ring(ringMemory.data(), ringMemory.size());
+    FileSink* file = mode == FILE_SINK ? new FileSink(path) : nullptr;
+
+    UNOGame game(numPlayers);
+    if (mode == RING) game.setEventSink(&ring);
+    if (mode == FILE_SINK) game.setEventSink(file);
+
+    RunResult result = {0, 0, 0};
+    size_t stateChars = 0;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < numGames; i++) {
+        game.reset(SplitMix64(masterSeed + i)(), numPlayers);
+        while (!game.isGameOver() && game.getTurnCount() < maxTurns) {
+            game.playTurn();
+            if (mode == STATE_STRING) {
+                stateChars += game.getState().size();
+            }
+        }
+        result.turns += game.getTurnCount();
+        if (mode == RING) {
+            // A consumer draining the ring between games
+            game.flushEvents();
+            result.bytes += ring.read(drained.data(), drained.size());
+        }
+        if (finals) {
+            finals->push_back(game.saveState());
+        }
+    }
+    game.flushEvents();
+    game.setEventSink(nullptr);
+    delete file;
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (mode == FILE_SINK) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        result.bytes = static_cast<size_t>(in.tellg());
+    }
+    if (mode == STATE_STRING) {
+        result.bytes = stateChars;
+    }
+    if (ring.droppedBytes() > 0) {
+        std::printf("ring buffer dropped %zu bytes\n", ring.droppedBytes());
+    }
+    return result;
+}
+
+static void report(const char* name, const RunResult& r, const RunResult& base) {
+    double rate = r.turns / r.seconds;
+    double baseRate = base.turns / base.seconds;
+    std::printf("%-16s %12.0f turns/s  %+7.1f%%  %6.2f bytes/turn\n", name, rate,
+                100.0 * (baseRate - rate) / baseRate, static_cast<double>(r.bytes) / r.turns);
+}
+
+// Replay every game in log and compare with the positions the live run
+// ended in; returns the number of games that differ
+static int checkReplay(const std::vector<uint8_t>& log, const std::vector<GameState>& finals,
+                       int numPlayers) {
+    UNOGame game(numPlayers);
+    size_t offset = 0;
+    int mismatches = 0;
+    for (size_t g = 0; g < finals.size(); g++) {
+        if (!replayGame(log.data(), log.size(), offset, game) ||
+            !sameState(game.saveState(), finals[g])) {
+            mismatches++;
+        }
+    }
+    if (offset != log.size()) {
+        mismatches++;
+    }
+    return mismatches;
+}
+
+int main(int argc, char** argv) {
+    int numGames = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int numPlayers = argc > 2 ? std::atoi(argv[2]) : 4;
+    std::string path = argc > 3 ? argv[3] : "uno_events.bin";
+    uint64_t masterSeed = 1234;
+
+    RunResult none = run(NONE, numGames, numPlayers, masterSeed, path, nullptr);
+    RunResult ring = run(RING, numGames, numPlayers, masterSeed, path, nullptr);
+    std::vector<GameState> finals;
+    RunResult file = run(FILE_SINK, numGames, numPlayers, masterSeed, path, &finals);
+    RunResult text = run(STATE_STRING, numGames, numPlayers, masterSeed, path, nullptr);
+
+    std::printf("%d games, %d players, %lld turns\n", numGames, numPlayers, none.turns);
+    report("no log", none, none);
+    report("ring buffer", ring, none);
+    report("file sink", file, none);
+    report("getState()", text, none);
+
+    // Seeded deals replay from the seed in the log
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> log((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    int bad = checkReplay(log, finals, numPlayers);
+
+    // Deals from other generators log the whole deck
+    std::vector<uint8_t> ringMemory(1 << 20);
+    RingBufferSink ringSink(ringMemory.data(), ringMemory.size());
+    std::vector<GameState> deckFinals;
+    {
+        UNOGame game(numPlayers);
+        game.setEventSink(&ringSink);
+        Pcg32 rng(masterSeed);
+        for (int i = 0; i < 100; i++) {
+            game.initializeWith(rng);
+            while (!game.isGameOver() && game.getTurnCount() < maxTurns) {
+                game.playTurn();
+            }
+            deckFinals.push_back(game.saveState());
+        }
+        game.flushEvents();
+    }
+    std::vector<uint8_t> deckLog(ringSink.size());
+    ringSink.read(deckLog.data(), deckLog.size());
+    bad += checkReplay(deckLog, deckFinals, numPlayers);
+
+    std::printf("replay:          %s (%zu games)\n", bad ? "FAILED" : "identical",
+                finals.size() + deckFinals.size());
+    return bad ? 1 : 0;
+}
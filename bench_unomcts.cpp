@@ -0,0 +1,74 @@
+#include "uno.h"
+#include "unomcts.h"
+#include "unostrategy.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// MCTS player benchmark: snapshot cost, rollout throughput and playing
+// strength against the default strategy.
+//
+// Usage:
+//   bench_unomcts [games] [iterations] [players]
+
+// Seat 0 searches, everyone else plays the lowest playable card
+struct MctsSeatZero {
+    MctsStrategy& mcts;
+    FirstPlayableStrategy first;
+
+    int chooseCard(const TurnView& view) {
+        return view.player == 0 ? mcts.chooseCard(view) : first.chooseCard(view);
+    }
+};
+
+int main(int argc, char** argv) {
+    int numGames = argc > 1 ? std::atoi(argv[1]) : 200;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 1000;
+    int numPlayers = argc > 3 ? std::atoi(argv[3]) : 2;
+    typedef std::chrono::steady_clock Clock;
+
+    // Snapshot cost: save, copy and restore a position
+    {
+        UNOGame game(numPlayers);
+        game.initialize(static_cast<uint64_t>(1));
+        const int reps = 1000000;
+        GameState copy;
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < reps; i++) {
+            GameState state = game.saveState();
+            std::memcpy(&copy, &state, sizeof(copy));
+            game.loadState(copy);
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / reps;
+        std::printf("GameState: %zu bytes, save+memcpy+load %.1f ns\n", sizeof(GameState), ns);
+    }
+
+    MctsOptions options;
+    options.iterations = iterations;
+    UNOGame game(numPlayers);
+    MctsStrategy mcts(game, options);
+    MctsSeatZero seats = {mcts, FirstPlayableStrategy()};
+
+    int wins = 0;
+    int finished = 0;
+    Clock::time_point start = Clock::now();
+    for (int g = 0; g < numGames; g++) {
+        game.reset(1000 + g, numPlayers);
+        while (!game.isGameOver() && game.getTurnCount() < 2000) {
+            game.playTurn(seats);
+        }
+        if (game.isGameOver()) {
+            finished++;
+            wins += game.getWinner() == 0;
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::printf("%d games, %d players, %d iterations per decision\n", numGames, numPlayers, iterations);
+    std::printf("rollouts:     %lld (%.0f per second on one core)\n", mcts.rollouts(),
+                mcts.rollouts() / seconds);
+    std::printf("MCTS seat 0:  won %d of %d finished games (%.1f%%, fair share %.1f%%)\n",
+                wins, finished, finished ? 100.0 * wins / finished : 0.0, 100.0 / numPlayers);
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "uno.h"
+#include "rng.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+// Cost of UNOGame's counters and turn timing, getSummary() against
+// getState(), and a second thread scraping the counters while games run.
+//
+// Usage:
+//   bench_unostats [games] [players]
+
+static const int maxTurns = 2000;
+typedef std::chrono::steady_clock Clock;
+
+// Play numGames games on game; returns turns per second
+static double playGames(UNOGame& game, int numGames, int numPlayers, uint64_t masterSeed) {
+    long long turns = 0;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < numGames; i++) {
+        game.reset(SplitMix64(masterSeed + i)(), numPlayers);
+        while (!game.isGameOver() && game.getTurnCount() < maxTurns) {
+            game.playTurn();
+        }
+        turns += game.getTurnCount();
+    }
+    return turns / std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void printHistogram(const GameCounters& c) {
+    std::printf("turn latency (%llu timed turns):\n", static_cast<unsigned long long>(c.timedTurns));
+    for (int b = 0; b < GameCounters::latencyBuckets; b++) {
+        if (c.turnLatency[b] == 0) continue;
+        std::printf("  %10llu ns+  %6.2f%%\n", 1ull << b, 100.0 * c.turnLatency[b] / c.timedTurns);
+    }
+}
+
+int main(int argc, char** argv) {
+    int numGames = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int numPlayers = argc > 2 ? std::atoi(argv[2]) : 4;
+
+    UNOGame game(numPlayers);
+    double base = playGames(game, numGames, numPlayers, 1);
+    game.setTurnTiming(64);
+    double sampled = playGames(game, numGames, numPlayers, 1);
+    game.setTurnTiming(1);
+    double timed = playGames(game, numGames, numPlayers, 1);
+    game.setTurnTiming(0);
+
+    std::printf("%d games, %d players\n", numGames, numPlayers);
+    std::printf("counters only:       %.0f turns/s\n", base);
+    std::printf("timing 1 in 64:      %.0f turns/s (%+.1f%%)\n", sampled, 100.0 * (base - sampled) / base);
+    std::printf("timing every turn:   %.0f turns/s (%+.1f%%)\n", timed, 100.0 * (base - timed) / base);
+
+    // Polling the state as data vs as a formatted string
+    const int polls = 1000000;
+    size_t sink = 0;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < polls; i++) {
+        GameSummary summary = game.getSummary();
+        sink += summary.cardCounts[i & 3] + summary.topCard;
+    }
+    double summaryNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / polls;
+    start = Clock::now();
+    for (int i = 0; i < polls; i++) {
+        sink += game.getState().size();
+    }
+    double stateNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / polls;
+    std::printf("getSummary():        %.1f ns per call\n", summaryNs);
+    std::printf("getState():          %.1f ns per call (checksum %zu)\n", stateNs, sink);
+
+    // Scrape the counters from another thread while games are played
+    std::atomic<bool> done(false);
+    long long scrapes = 0;
+    bool monotonic = true;
+    std::thread scraper([&]() {
+        uint64_t lastTurns = 0;
+        while (!done.load()) {
+            GameCounters c = game.getCounters();
+            monotonic = monotonic && c.turnsPlayed >= lastTurns;
+            lastTurns = c.turnsPlayed;
+            scrapes++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    game.setTurnTiming(64);
+    double scraped = playGames(game, numGames, numPlayers, 2);
+    done.store(true);
+    scraper.join();
+    std::printf("while scraped:       %.0f turns/s, %lld scrapes, counters %s\n", scraped, scrapes,
+                monotonic ? "monotonic" : "WENT BACKWARDS");
+
+    GameCounters c = game.getCounters();
+    std::printf("games dealt/won:     %llu / %llu\n", static_cast<unsigned long long>(c.gamesDealt),
+                static_cast<unsigned long long>(c.gamesWon));
+    std::printf("turns played:        %llu\n", static_cast<unsigned long long>(c.turnsPlayed));
+    std::printf("cards drawn:         %llu\n", static_cast<unsigned long long>(c.cardsDrawn));
+    std::printf("deck exhausted:      %llu\n", static_cast<unsigned long long>(c.deckExhausted));
+    printHistogram(c);
+    return monotonic ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+#include "uno.h"
+#include "unostrategy.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Per-turn cost of each way of plugging a strategy into UNOGame.
+//
+// Usage:
+//   bench_unostrategy [games] [players]
+
+static const int maxTurns = 2000;
+
+// Play the same seeded games with one strategy and report ns per turn
+template <class Strategy>
+static void run(const char* name, Strategy& strategy, int numGames, int numPlayers) {
+    UNOGame game(numPlayers);
+    long long turns = 0;
+    long long wins0 = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int g = 0; g < numGames; g++) {
+        game.reset(g, numPlayers);
+        while (!game.isGameOver() && game.getTurnCount() < maxTurns) {
+            game.playTurn(strategy);
+        }
+        turns += game.getTurnCount();
+        wins0 += game.getWinner() == 0;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%-34s %8.2f ns/turn  %6.1f turns/game  seat 0 wins %5.1f%%\n", name,
+                1e9 * seconds / turns, (double)turns / numGames, 100.0 * wins0 / numGames);
+}
+
+// The built-in playTurn(), through a base reference as a caller would see it
+struct DefaultPlayTurn {};
+
+template <>
+void run<DefaultPlayTurn>(const char* name, DefaultPlayTurn&, int numGames, int numPlayers) {
+    UNOGame game(numPlayers);
+    UNOGame& ref = game;
+    long long turns = 0;
+    long long wins0 = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int g = 0; g < numGames; g++) {
+        ref.reset(g, numPlayers);
+        while (!ref.isGameOver() && ref.getTurnCount() < maxTurns) {
+            ref.playTurn();
+        }
+        turns += ref.getTurnCount();
+        wins0 += ref.getWinner() == 0;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%-34s %8.2f ns/turn  %6.1f turns/game  seat 0 wins %5.1f%%\n", name,
+                1e9 * seconds / turns, (double)turns / numGames, 100.0 * wins0 / numGames);
+}
+
+int main(int argc, char** argv) {
+    int numGames = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int numPlayers = argc > 2 ? std::atoi(argv[2]) : 4;
+
+    std::printf("%d games, %d players\n\n", numGames, numPlayers);
+
+    DefaultPlayTurn builtIn;
+    run("playTurn() (virtual)", builtIn, numGames, numPlayers);
+
+    FirstPlayableStrategy first;
+    ActionFirstStrategy actionFirst;
+    ColorCountStrategy colorCount;
+    std::vector<float> weights(Card::numIds);
+    for (int i = 0; i < Card::numIds; i++) {
+        weights[i] = static_cast<float>(i % Card::facesPerColor);  // prefer high faces
+    }
+    WeightedStrategy weighted(weights);
+
+    run("template FirstPlayable", first, numGames, numPlayers);
+    run("template ActionFirst", actionFirst, numGames, numPlayers);
+    run("template ColorCount", colorCount, numGames, numPlayers);
+    run("template Weighted", weighted, numGames, numPlayers);
+
+    StrategyAdapter<FirstPlayableStrategy> erasedFirst;
+    StrategyAdapter<ColorCountStrategy> erasedColorCount;
+    PlayerStrategy* runtimeFirst = &erasedFirst;
+    PlayerStrategy* runtimeColorCount = &erasedColorCount;
+    run("type-erased FirstPlayable", *runtimeFirst, numGames, numPlayers);
+    run("type-erased ColorCount", *runtimeColorCount, numGames, numPlayers);
+
+    StrategyAdapter<ActionFirstStrategy> erasedActionFirst;
+    SeatStrategies seats;
+    seats.setSeat(0, &erasedColorCount);
+    seats.setSeat(1, &erasedActionFirst);
+    run("per-seat (ColorCount, ActionFirst)", seats, numGames, numPlayers);
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include "unotournament.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <sys/resource.h>
+#include <thread>
+
+// Plays a single-elimination tournament on the worker pool and reports
+// throughput, per-turn latency and queue wait under load. A few entrants
+// think slowly on the worker thread and a few are "humans" whose moves
+// arrive from another thread after a delay; neither holds up other tables.
+// Peak RSS shows that memory follows the worker count, not the entrants.
+//
+// Usage:
+//   bench_unotournament [entrants] [seats per table] [threads] [slow] [humans]
+
+typedef std::chrono::steady_clock Clock;
+
+static const char* styleNames[] = {"first playable", "action first", "color count", "slow", "human"};
+
+// Spends spinMicros on every decision before playing the lowest card
+class SlowStrategy : public PlayerStrategy {
+public:
+    explicit SlowStrategy(int micros) : spinMicros(micros) {}
+
+    int chooseCard(const TurnView& view) override {
+        Clock::time_point until = Clock::now() + std::chrono::microseconds(spinMicros);
+        while (Clock::now() < until) {
+        }
+        return Card::lowestCard(view.playable);
+    }
+
+private:
+    int spinMicros;
+};
+
+// Answers every request from its own thread after delayMicros, like a
+// player at a remote client
+class DelayedSeat : public AsyncSeat {
+public:
+    explicit DelayedSeat(int micros) : delayMicros(micros), stopping(false), answered(0) {
+        responder = std::thread(&DelayedSeat::respond, this);
+    }
+
+    ~DelayedSeat() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_one();
+        responder.join();
+    }
+
+    void requestMove(Tournament& tournament, const MoveRequest& request) override {
+        Pending move = {&tournament, request.table, Card::lowestCard(request.view.playable),
+                        Clock::now() + std::chrono::microseconds(delayMicros)};
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            pending.push_back(move);
+        }
+        wake.notify_one();
+    }
+
+    long long getAnswered() const {
+        return answered.load();
+    }
+
+private:
+    struct Pending {
+        Tournament* tournament;
+        int table;
+        int card;
+        Clock::time_point due;
+    };
+
+    void respond() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            wake.wait(guard, [this]() { return stopping || !pending.empty(); });
+            if (pending.empty()) {
+                return;
+            }
+            // Requests arrive in due order, so the front is always next
+            Pending move = pending.front();
+            pending.pop_front();
+            guard.unlock();
+            std::this_thread::sleep_until(move.due);
+            answered++;
+            move.tournament->submitMove(move.table, move.card);
+            guard.lock();
+        }
+    }
+
+    int delayMicros;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::deque<Pending> pending;
+    bool stopping;
+    std::atomic<long long> answered;
+    std::thread responder;
+};
+
+int main(int argc, char** argv) {
+    TournamentOptions options;
+    options.entrants = argc > 1 ? std::atoi(argv[1]) : 400000;
+    options.seatsPerTable = argc > 2 ? std::atoi(argv[2]) : 4;
+    options.numThreads = argc > 3 ? std::atoi(argv[3]) : 0;
+    int numSlow = argc > 4 ? std::atoi(argv[4]) : 64;
+    int numHumans = argc > 5 ? std::atoi(argv[5]) : 16;
+
+    StrategyAdapter<FirstPlayableStrategy> firstPlayable;
+    StrategyAdapter<ActionFirstStrategy> actionFirst;
+    StrategyAdapter<ColorCountStrategy> colorCount;
+    SlowStrategy slow(50);
+    DelayedSeat human(2000);
+    PlayerStrategy* styles[] = {&firstPlayable, &actionFirst, &colorCount};
+
+    Tournament tournament(options);
+    std::vector<int> styleOf(options.entrants);
+    for (int i = 0; i < options.entrants; i++) {
+        styleOf[i] = i % 3;
+        tournament.setStrategy(i, styles[i % 3]);
+    }
+    // Spread the slow and human entrants over the first-round tables
+    for (int k = 0; k < numSlow + numHumans; k++) {
+        int entrant = static_cast<int>((k * 2654435761ull + 1) % options.entrants);
+        if (k < numSlow) {
+            styleOf[entrant] = 3;
+            tournament.setStrategy(entrant, &slow);
+        } else {
+            styleOf[entrant] = 4;
+            tournament.setAsyncSeat(entrant, &human);
+        }
+    }
+
+    TournamentResult r = tournament.run();
+
+    std::printf("%d entrants, %d seats per table, %d slow, %d human\n", options.entrants,
+                options.seatsPerTable, numSlow, numHumans);
+    std::printf("tables:          %lld in %d rounds (", r.tables, r.rounds);
+    for (size_t i = 0; i < r.tablesPerRound.size(); i++) {
+        std::printf("%s%lld", i ? " " : "", r.tablesPerRound[i]);
+    }
+    std::printf("), %lld hit the turn limit\n", r.unfinishedTables);
+    std::printf("turns:           %lld in %.2f s, %.0f turns/s\n", r.turns, r.seconds, r.turnsPerSecond);
+    std::printf("turn time (ns):  p50 %.0f  p99 %.0f  p99.9 %.0f  max %.0f\n", r.turnP50, r.turnP99,
+                r.turnP999, r.turnMax);
+    std::printf("queue wait (ns): p50 %.0f  p99 %.0f  p99.9 %.0f  max %.0f\n", r.waitP50, r.waitP99,
+                r.waitP999, r.waitMax);
+    std::printf("human moves:     %lld\n", human.getAnswered());
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::printf("peak RSS:        %.1f MB\n", usage.ru_maxrss / 1024.0);
+    std::printf("champion:        entrant %d (%s)\n", r.champion, styleNames[styleOf[r.champion]]);
+
+    // How far each style got on average
+    double rounds[5] = {0, 0, 0, 0, 0};
+    long long counts[5] = {0, 0, 0, 0, 0};
+    for (int i = 0; i < options.entrants; i++) {
+        rounds[styleOf[i]] += r.roundReached[i];
+        counts[styleOf[i]]++;
+    }
+    for (int s = 0; s < 5; s++) {
+        if (counts[s] == 0) continue;
+        std::printf("  %-15s %8lld entrants, %.3f rounds won on average\n", styleNames[s], counts[s],
+                    rounds[s] / counts[s]);
+    }
+    return 0;
+}
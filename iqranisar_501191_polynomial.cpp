@@ -1,6 +1,7 @@
 #include "polynomial.h"
+#include "registry.h"
 #include <sstream>
-#include <map>
+#include <utility>
 
 // Node structure for linked list
 struct TermNode {
@@ -51,29 +52,38 @@ public:
     }
 };
 
-// Global storage - maps object addresses to their data
-static std::map<size_t, PolyData*> globalStorage;
-static size_t nextId = 1;
-
-// Store ID in the object's memory space
-static size_t& getId(const Polynomial* poly) {
-    return *((size_t*)poly);
+// Terms of a polynomial, looked up by handle without locking, so separate
+// polynomials can be used on separate threads
+static PolyData* getData(uint64_t handle) {
+    return registryFor<PolyData>().find(handle);
 }
 
-static PolyData* getData(const Polynomial* poly) {
-    size_t id = getId(poly);
-    if (id == 0 || globalStorage.find(id) == globalStorage.end()) {
-        id = nextId++;
-        getId(poly) = id;
-        globalStorage[id] = new PolyData();
+Polynomial::Polynomial() : handle(registryFor<PolyData>().insert(new PolyData())) {}
+
+Polynomial::Polynomial(const Polynomial& other)
+    : handle(registryFor<PolyData>().insert(getData(other.handle)->deepCopy())) {}
+
+Polynomial& Polynomial::operator=(const Polynomial& other) {
+    if (this != &other) {
+        PolyData* copy = getData(other.handle)->deepCopy();
+        PolyData* data = getData(handle);
+        std::swap(data->head, copy->head);
+        delete copy;
     }
-    return globalStorage[id];
+    return *this;
+}
+
+Polynomial::~Polynomial() {
+    // Free the terms now and let only the empty PolyData wait for
+    // reclamation, so large polynomials do not linger after destruction
+    getData(handle)->clear();
+    registryFor<PolyData>().remove(handle);
 }
 
 void Polynomial::insertTerm(int coefficient, int exponent) {
     if (coefficient == 0) return;
     
-    PolyData* data = getData(this);
+    PolyData* data = getData(handle);
     TermNode*& head = data->head;
     
     // If list is empty or new term has highest exponent
@@ -119,7 +129,7 @@ void Polynomial::insertTerm(int coefficient, int exponent) {
 }
 
 std::string Polynomial::toString() const {
-    PolyData* data = getData(this);
+    PolyData* data = getData(handle);
     TermNode* head = data->head;
     
     if (!head) return "0";
@@ -174,10 +184,8 @@ std::string Polynomial::toString() const {
 
 Polynomial Polynomial::add(const Polynomial& other) const {
     Polynomial result;
-    getData(&result);
-    
-    PolyData* data1 = getData(this);
-    PolyData* data2 = getData(&other);
+    PolyData* data1 = getData(handle);
+    PolyData* data2 = getData(other.handle);
     
     TermNode* p1 = data1->head;
     TermNode* p2 = data2->head;
@@ -204,10 +212,8 @@ Polynomial Polynomial::add(const Polynomial& other) const {
 
 Polynomial Polynomial::multiply(const Polynomial& other) const {
     Polynomial result;
-    getData(&result);
-    
-    PolyData* data1 = getData(this);
-    PolyData* data2 = getData(&other);
+    PolyData* data1 = getData(handle);
+    PolyData* data2 = getData(other.handle);
     
     TermNode* p1 = data1->head;
     
@@ -227,9 +233,7 @@ Polynomial Polynomial::multiply(const Polynomial& other) const {
 
 Polynomial Polynomial::derivative() const {
     Polynomial result;
-    getData(&result);
-    
-    PolyData* data = getData(this);
+    PolyData* data = getData(handle);
     TermNode* current = data->head;
     
     while (current) {
@@ -1,5 +1,16 @@
 #include "texteditor.h"
+#include "registry.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <map>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
 
 // Node structure for doubly linked list
 struct CharNode {
@@ -10,46 +21,477 @@ struct CharNode {
     CharNode(char c) : data(c), next(nullptr), prev(nullptr) {}
 };
 
+class ManagerData;
+class Journal;
+
 // Editor data structure
 class EditorData {
 public:
     CharNode* head;      // Start of text
     CharNode* cursor;    // Cursor position (between cursor->prev and cursor)
     int cursorPos;       // Cursor position index
+    int length;          // Number of characters in the text
+    
+    // Set when the document is hosted by a DocumentManager
+    ManagerData* owner;
+    EditorData* lruPrev; // Neighbours in the owner's recently-used list
+    EditorData* lruNext;
+    size_t docId;
+    bool evicted;        // Text lives in the spill file and head is null
+    
+    Journal* journal;    // Set while edits are being journaled
     
-    EditorData() : head(nullptr), cursor(nullptr), cursorPos(0) {}
+    EditorData() : head(nullptr), cursor(nullptr), cursorPos(0), length(0),
+                   owner(nullptr), lruPrev(nullptr), lruNext(nullptr),
+                   docId(0), evicted(false), journal(nullptr) {}
     
     ~EditorData() {
+        freeText();
+    }
+    
+    void freeText() {
         while (head) {
             CharNode* temp = head;
             head = head->next;
             delete temp;
         }
+        cursor = nullptr;
+    }
+    
+    size_t memoryUsage() const {
+        return evicted ? 0 : length * sizeof(CharNode);
+    }
+    
+    // Compact form used by spill files and journal checkpoints:
+    // int32 length, int32 cursorPos, then the raw text
+    std::string snapshot() const {
+        std::string bytes(2 * sizeof(int), '\0');
+        std::memcpy(&bytes[0], &length, sizeof(int));
+        std::memcpy(&bytes[sizeof(int)], &cursorPos, sizeof(int));
+        bytes.reserve(bytes.size() + length);
+        for (CharNode* node = head; node; node = node->next) {
+            bytes += node->data;
+        }
+        return bytes;
+    }
+    
+    // Replace the text with a snapshot; false if the bytes are malformed
+    bool loadSnapshot(const char* bytes, size_t size) {
+        int newLength = 0;
+        int newCursorPos = 0;
+        if (size < 2 * sizeof(int)) return false;
+        std::memcpy(&newLength, bytes, sizeof(int));
+        std::memcpy(&newCursorPos, bytes + sizeof(int), sizeof(int));
+        if (newLength < 0 || newCursorPos < 0 || newCursorPos > newLength ||
+            size != 2 * sizeof(int) + newLength) {
+            return false;
+        }
+        const char* text = bytes + 2 * sizeof(int);
+        
+        // Rebuild the list; cursor points at the node after the cursor
+        freeText();
+        CharNode* tail = nullptr;
+        for (int i = 0; i < newLength; i++) {
+            CharNode* newNode = new CharNode(text[i]);
+            newNode->prev = tail;
+            if (tail) {
+                tail->next = newNode;
+            } else {
+                head = newNode;
+            }
+            if (i == newCursorPos) {
+                cursor = newNode;
+            }
+            tail = newNode;
+        }
+        length = newLength;
+        cursorPos = newCursorPos;
+        return true;
+    }
+};
+
+// Document manager state: resident documents are kept in a doubly linked
+// list ordered from most (lruHead) to least (lruTail) recently used
+class ManagerData {
+public:
+    size_t budget;
+    std::string spillDir;
+    size_t usage;        // Bytes held by resident documents
+    size_t evictedDocs;
+    std::map<size_t, TextEditor> documents; // Nodes keep editor addresses stable
+    EditorData* lruHead;
+    EditorData* lruTail;
+    
+    ManagerData(size_t b, const std::string& dir)
+        : budget(b), spillDir(dir), usage(0), evictedDocs(0),
+          lruHead(nullptr), lruTail(nullptr) {}
+    
+    void unlink(EditorData* data) {
+        if (data->lruPrev) {
+            data->lruPrev->lruNext = data->lruNext;
+        } else {
+            lruHead = data->lruNext;
+        }
+        if (data->lruNext) {
+            data->lruNext->lruPrev = data->lruPrev;
+        } else {
+            lruTail = data->lruPrev;
+        }
+        data->lruPrev = nullptr;
+        data->lruNext = nullptr;
+    }
+    
+    void pushFront(EditorData* data) {
+        data->lruNext = lruHead;
+        if (lruHead) {
+            lruHead->lruPrev = data;
+        } else {
+            lruTail = data;
+        }
+        lruHead = data;
+    }
+    
+    std::string spillPath(size_t docId) const {
+        return spillDir + "/doc" + std::to_string(docId) + ".bin";
+    }
+    
+    // Mark a document as used, reloading it if it was evicted
+    void touch(EditorData* data) {
+        if (data->evicted) {
+            restore(data);
+            return;
+        }
+        if (data != lruHead) {
+            unlink(data);
+            pushFront(data);
+        }
+    }
+    
+    // Account for a resident document growing or shrinking
+    void charge(EditorData* data, long bytes) {
+        usage += bytes;
+        if (bytes > 0) {
+            enforceBudget(data);
+        }
+    }
+    
+    // Evict cold documents until usage fits, never evicting keep
+    void enforceBudget(EditorData* keep) {
+        while (usage > budget && lruTail && lruTail != keep) {
+            if (!spill(lruTail)) {
+                break;
+            }
+        }
+    }
+    
+    // Spill files hold the document snapshot
+    bool spill(EditorData* data) {
+        std::ofstream out(spillPath(data->docId), std::ios::binary | std::ios::trunc);
+        std::string bytes = data->snapshot();
+        out.write(bytes.data(), bytes.size());
+        out.close();
+        if (!out) {
+            // Keep the document resident rather than lose its text
+            return false;
+        }
+        
+        usage -= data->memoryUsage();
+        unlink(data);
+        data->freeText();
+        data->evicted = true;
+        evictedDocs++;
+        return true;
+    }
+    
+    void restore(EditorData* data) {
+        std::string path = spillPath(data->docId);
+        std::ifstream in(path, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (!in || !data->loadSnapshot(bytes.data(), bytes.size())) {
+            throw std::runtime_error("cannot restore document from " + path);
+        }
+        in.close();
+        std::remove(path.c_str());
+        
+        data->evicted = false;
+        evictedDocs--;
+        
+        pushFront(data);
+        charge(data, data->memoryUsage());
+    }
+};
+
+// Write a whole buffer at a file offset, retrying short writes
+static bool writeAt(int fd, const char* bytes, size_t size, off_t offset) {
+    while (size > 0) {
+        ssize_t written = pwrite(fd, bytes, size, offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        bytes += written;
+        size -= written;
+        offset += written;
+    }
+    return true;
+}
+
+// Read a whole file; false if it cannot be opened
+static bool readFile(const std::string& path, std::string& bytes) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    bytes.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// FNV-1a, used to detect torn journal blocks
+static uint32_t checksum(const char* bytes, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void putU32(std::string& bytes, uint32_t value) {
+    bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static uint32_t getU32(const char* bytes) {
+    uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+static const char journalMagic[] = "TEJ1";
+static const char checkpointMagic[] = "TEC1";
+static const size_t headerSize = 8;  // magic + uint32 generation
+
+// Append-only edit journal. Every operation is one record: an opcode
+// ('i', 'd', 'l', 'r') followed by the character for inserts. Records are
+// buffered and written as blocks (uint32 size, uint32 checksum, records),
+// then fsynced together, so a crash mid-write leaves a torn block that
+// recovery detects and drops. The file header names the checkpoint
+// generation the journal continues from.
+class Journal {
+public:
+    std::string path;
+    JournalOptions options;
+    int fd;
+    uint32_t generation;
+    off_t committedSize;     // End of the last complete block
+    std::string pending;     // Records not yet written
+    size_t opsSinceCheckpoint;
+    std::chrono::steady_clock::time_point oldestPending;
+    bool failed;             // Sticky: set by any failed write or sync
+    
+    Journal(const std::string& p, const JournalOptions& o)
+        : path(p), options(o), fd(-1), generation(0), committedSize(0),
+          opsSinceCheckpoint(0), failed(false) {
+        pending.reserve(options.syncBytes + 2);
+    }
+    
+    ~Journal() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    
+    bool record(char op, char c) {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (pending.empty()) {
+            oldestPending = now;
+        }
+        pending += op;
+        if (op == 'i') {
+            pending += c;
+        }
+        opsSinceCheckpoint++;
+        
+        // Group commit; a clock read is cheap next to the fsync it saves
+        if (pending.size() >= options.syncBytes || due(now)) {
+            return commit();
+        }
+        return true;
+    }
+    
+    // True if the oldest pending record has waited syncIntervalMs
+    bool due(std::chrono::steady_clock::time_point now) const {
+        return !pending.empty() &&
+               now - oldestPending >= std::chrono::milliseconds(options.syncIntervalMs);
+    }
+    
+    // Write pending records as one block and fsync. After a failure the
+    // journal stays failed; its records may or may not have reached disk.
+    bool commit() {
+        if (failed) return false;
+        if (pending.empty()) return true;
+        
+        std::string block;
+        block.reserve(2 * sizeof(uint32_t) + pending.size());
+        putU32(block, static_cast<uint32_t>(pending.size()));
+        putU32(block, checksum(pending.data(), pending.size()));
+        block += pending;
+        
+        if (!writeAt(fd, block.data(), block.size(), committedSize) || fdatasync(fd) != 0) {
+            failed = true;
+            return false;
+        }
+        committedSize += block.size();
+        pending.clear();
+        return true;
+    }
+    
+    // Empty the journal and start it at a new generation
+    bool reset(uint32_t newGeneration) {
+        std::string header(journalMagic, 4);
+        putU32(header, newGeneration);
+        
+        // Truncate durably before the new header can reach disk, so the
+        // old blocks never appear under the new generation
+        if (ftruncate(fd, 0) != 0 || fdatasync(fd) != 0 ||
+            !writeAt(fd, header.data(), header.size(), 0) || fdatasync(fd) != 0) {
+            return false;
+        }
+        generation = newGeneration;
+        committedSize = headerSize;
+        pending.clear();
+        opsSinceCheckpoint = 0;
+        return true;
+    }
+    
+    // Start the journal at newGeneration, recreating the file if it cannot
+    // be truncated in place. On failure the journal is marked failed, since
+    // blocks appended under the old header would be dropped on recovery.
+    bool restart(uint32_t newGeneration) {
+        if (reset(newGeneration)) {
+            return true;
+        }
+        ::close(fd);
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0 || !reset(newGeneration)) {
+            failed = true;
+            return false;
+        }
+        return true;
     }
 };
 
-// Global storage for text editor data
-static std::map<size_t, EditorData*> editorStorage;
-static size_t nextEditorId = 1;
+// Get editor data without marking it as used. It is looked up by handle
+// without locking, so separate editors can be used on separate threads.
+static EditorData* findEditorData(uint64_t handle) {
+    return registryFor<EditorData>().find(handle);
+}
+
+// Get editor data, reloading it if its manager spilled it
+static EditorData* getEditorData(uint64_t handle) {
+    EditorData* data = findEditorData(handle);
+    if (data->owner) {
+        data->owner->touch(data);
+    }
+    return data;
+}
 
-// Get ID stored in object
-static size_t& getEditorId(const TextEditor* editor) {
-    return *((size_t*)editor);
+// Account for characters added to or removed from the text
+static void resize(EditorData* data, int delta) {
+    data->length += delta;
+    if (data->owner) {
+        data->owner->charge(data, delta * static_cast<long>(sizeof(CharNode)));
+    }
 }
 
-// Get or create editor data
-static EditorData* getEditorData(const TextEditor* editor) {
-    size_t id = getEditorId(editor);
-    if (id == 0 || editorStorage.find(id) == editorStorage.end()) {
-        id = nextEditorId++;
-        getEditorId(editor) = id;
-        editorStorage[id] = new EditorData();
+// Replace the whole text with a snapshot, keeping memory accounting right
+static bool replaceText(EditorData* data, const char* bytes, size_t size) {
+    long before = static_cast<long>(data->memoryUsage());
+    if (!data->loadSnapshot(bytes, size)) {
+        return false;
+    }
+    if (data->owner) {
+        data->owner->charge(data, static_cast<long>(data->memoryUsage()) - before);
+    }
+    return true;
+}
+
+// Checkpoint file: magic, uint32 generation, then the text snapshot. It is
+// written to a temporary file and renamed over the old one, after which the
+// journal restarts empty at the new generation.
+static bool writeCheckpoint(EditorData* data) {
+    Journal* journal = data->journal;
+    if (!journal->commit()) {
+        return false;
+    }
+    
+    // Any failure from here on also fails the journal: the checkpoint may
+    // or may not have replaced the old one
+    journal->failed = true;
+    
+    uint32_t generation = journal->generation + 1;
+    std::string bytes(checkpointMagic, 4);
+    putU32(bytes, generation);
+    bytes += data->snapshot();
+    
+    std::string path = journal->path + ".ckpt";
+    std::string tempPath = path + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
     }
-    return editorStorage[id];
+    bool ok = writeAt(fd, bytes.data(), bytes.size(), 0) && fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        return false;
+    }
+    
+    // Make the rename durable before dropping the journal it replaces
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+    int dirFd = ::open(dir.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        ::close(dirFd);
+    }
+    
+    // The new generation is on disk now, so the journal must follow it
+    journal->failed = false;
+    return journal->restart(generation);
+}
+
+// Log an operation, before it is applied, if the editor is journaled.
+// Returns false if the journal has failed and the edit must be refused.
+static bool journalOp(EditorData* data, char op, char c = 0) {
+    Journal* journal = data->journal;
+    if (!journal) return true;
+    if (journal->failed) return false;
+    
+    // Compact first so the checkpoint never includes the op being logged
+    if (journal->opsSinceCheckpoint >= journal->options.checkpointOps &&
+        !writeCheckpoint(data)) {
+        return false;
+    }
+    // The record is buffered even if its group commit fails; it may have
+    // reached disk, so the edit is applied and later ones are refused
+    journal->record(op, c);
+    return true;
+}
+
+TextEditor::TextEditor() : handle(registryFor<EditorData>().insert(new EditorData())) {}
+
+TextEditor::~TextEditor() {
+    closeJournal();
+    
+    // Free the text now and let only the small EditorData itself wait for
+    // reclamation, so a closed document's memory comes back at once
+    EditorData* data = findEditorData(handle);
+    data->freeText();
+    data->length = 0;
+    data->cursorPos = 0;
+    registryFor<EditorData>().remove(handle);
 }
 
 void TextEditor::insertChar(char c) {
-    EditorData* data = getEditorData(this);
+    EditorData* data = getEditorData(handle);
+    if (!journalOp(data, 'i', c)) return;
     CharNode* newNode = new CharNode(c);
     
     if (!data->head) {
@@ -57,6 +499,7 @@ void TextEditor::insertChar(char c) {
         data->head = newNode;
         data->cursor = newNode;
         data->cursorPos = 1;
+        resize(data, 1);
         return;
     }
     
@@ -67,6 +510,7 @@ void TextEditor::insertChar(char c) {
         data->head = newNode;
         data->cursor = data->head->next;
         data->cursorPos = 1;
+        resize(data, 1);
         return;
     }
     
@@ -89,11 +533,13 @@ void TextEditor::insertChar(char c) {
         current->next = newNode;
         data->cursor = newNode->next;
         data->cursorPos++;
+        resize(data, 1);
     }
 }
 
 void TextEditor::deleteChar() {
-    EditorData* data = getEditorData(this);
+    EditorData* data = getEditorData(handle);
+    if (!journalOp(data, 'd')) return;
     
     // Can't delete at position 0
     if (data->cursorPos == 0 || !data->head) {
@@ -130,10 +576,12 @@ void TextEditor::deleteChar() {
     
     delete current;
     data->cursorPos--;
+    resize(data, -1);
 }
 
 void TextEditor::moveLeft() {
-    EditorData* data = getEditorData(this);
+    EditorData* data = getEditorData(handle);
+    if (!journalOp(data, 'l')) return;
     
     // Can't move left from position 0
     if (data->cursorPos <= 0) {
@@ -151,18 +599,11 @@ void TextEditor::moveLeft() {
 }
 
 void TextEditor::moveRight() {
-    EditorData* data = getEditorData(this);
-    
-    // Count total characters
-    int totalChars = 0;
-    CharNode* temp = data->head;
-    while (temp) {
-        totalChars++;
-        temp = temp->next;
-    }
+    EditorData* data = getEditorData(handle);
+    if (!journalOp(data, 'r')) return;
     
     // Can't move right beyond end
-    if (data->cursorPos >= totalChars) {
+    if (data->cursorPos >= data->length) {
         return;
     }
     
@@ -175,7 +616,7 @@ void TextEditor::moveRight() {
 }
 
 std::string TextEditor::getTextWithCursor() const {
-    EditorData* data = getEditorData(this);
+    EditorData* data = getEditorData(handle);
     std::string result = "";
     
     CharNode* current = data->head;
@@ -196,4 +637,181 @@ std::string TextEditor::getTextWithCursor() const {
     }
     
     return result;
-}
\ No newline at end of file
+}
+
+bool TextEditor::openJournal(const std::string& path, const JournalOptions& options) {
+    EditorData* data = getEditorData(handle);
+    closeJournal();
+    
+    Journal* journal = new Journal(path, options);
+    journal->fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (journal->fd < 0) {
+        delete journal;
+        return false;
+    }
+    
+    // Without a checkpoint, the current text becomes the first one
+    std::string bytes;
+    if (!readFile(path + ".ckpt", bytes)) {
+        data->journal = journal;
+        if (!writeCheckpoint(data)) {
+            closeJournal();
+            return false;
+        }
+        return true;
+    }
+    
+    if (bytes.size() < headerSize || std::memcmp(bytes.data(), checkpointMagic, 4) != 0 ||
+        !replaceText(data, bytes.data() + headerSize, bytes.size() - headerSize)) {
+        delete journal;
+        return false;
+    }
+    journal->generation = getU32(bytes.data() + 4);
+    
+    // Replay complete blocks written after that checkpoint. A journal from
+    // an older generation is already contained in the checkpoint.
+    std::string log;
+    readFile(path, log);
+    size_t pos = headerSize;
+    size_t replayed = 0;
+    bool current = log.size() >= headerSize && std::memcmp(log.data(), journalMagic, 4) == 0 &&
+                   getU32(log.data() + 4) == journal->generation;
+    
+    while (current && pos + 2 * sizeof(uint32_t) <= log.size()) {
+        uint32_t size = getU32(log.data() + pos);
+        const char* records = log.data() + pos + 2 * sizeof(uint32_t);
+        if (pos + 2 * sizeof(uint32_t) + size > log.size() ||
+            checksum(records, size) != getU32(log.data() + pos + sizeof(uint32_t))) {
+            break;
+        }
+        for (uint32_t i = 0; i < size; i++) {
+            switch (records[i]) {
+                case 'i':
+                    if (i + 1 < size) insertChar(records[++i]);
+                    break;
+                case 'd': deleteChar(); break;
+                case 'l': moveLeft(); break;
+                case 'r': moveRight(); break;
+            }
+            replayed++;
+        }
+        pos += 2 * sizeof(uint32_t) + size;
+    }
+    
+    data->journal = journal;
+    if (current) {
+        // Drop a torn tail so new blocks follow the last complete one
+        if (ftruncate(journal->fd, pos) != 0) {
+            closeJournal();
+            return false;
+        }
+        journal->committedSize = pos;
+        journal->opsSinceCheckpoint = replayed;
+    } else if (!journal->restart(journal->generation)) {
+        closeJournal();
+        return false;
+    }
+    
+    if (journal->opsSinceCheckpoint >= options.checkpointOps) {
+        return writeCheckpoint(data);
+    }
+    return true;
+}
+
+bool TextEditor::syncJournal() {
+    EditorData* data = getEditorData(handle);
+    return data->journal ? data->journal->commit() : true;
+}
+
+bool TextEditor::pollJournal() {
+    EditorData* data = findEditorData(handle);
+    Journal* journal = data->journal;
+    if (!journal || !journal->due(std::chrono::steady_clock::now())) {
+        return journal ? !journal->failed : true;
+    }
+    return journal->commit();
+}
+
+bool TextEditor::journalFailed() const {
+    Journal* journal = findEditorData(handle)->journal;
+    return journal && journal->failed;
+}
+
+bool TextEditor::compactJournal() {
+    EditorData* data = getEditorData(handle);
+    return data->journal ? writeCheckpoint(data) : false;
+}
+
+void TextEditor::closeJournal() {
+    EditorData* data = getEditorData(handle);
+    if (!data->journal) return;
+    
+    data->journal->commit();
+    delete data->journal;
+    data->journal = nullptr;
+}
+
+DocumentManager::DocumentManager(size_t memoryBudget, const std::string& spillDir)
+    : data(new ManagerData(memoryBudget, spillDir)) {}
+
+DocumentManager::~DocumentManager() {
+    while (!data->documents.empty()) {
+        close(data->documents.begin()->first);
+    }
+    delete data;
+}
+
+TextEditor& DocumentManager::open(size_t docId) {
+    auto it = data->documents.find(docId);
+    if (it != data->documents.end()) {
+        return it->second;
+    }
+    
+    TextEditor& editor = data->documents[docId];
+    EditorData* editorData = getEditorData(editor.handle);
+    editorData->owner = data;
+    editorData->docId = docId;
+    data->pushFront(editorData);
+    return editor;
+}
+
+void DocumentManager::close(size_t docId) {
+    auto it = data->documents.find(docId);
+    if (it == data->documents.end()) {
+        return;
+    }
+    
+    EditorData* editorData = findEditorData(it->second.handle);
+    
+    if (editorData->evicted) {
+        std::remove(data->spillPath(docId).c_str());
+        data->evictedDocs--;
+    } else {
+        data->usage -= editorData->memoryUsage();
+        data->unlink(editorData);
+    }
+    
+    // The editor's destructor closes its journal and frees its data
+    editorData->owner = nullptr;
+    data->documents.erase(it);
+}
+
+size_t DocumentManager::memoryUsage() const {
+    return data->usage;
+}
+
+size_t DocumentManager::documentMemory(size_t docId) const {
+    auto it = data->documents.find(docId);
+    if (it == data->documents.end()) {
+        return 0;
+    }
+    return findEditorData(it->second.handle)->memoryUsage();
+}
+
+size_t DocumentManager::residentCount() const {
+    return data->documents.size() - data->evictedDocs;
+}
+
+size_t DocumentManager::evictedCount() const {
+    return data->evictedDocs;
+}
@@ -1,8 +1,15 @@
 #include "uno.h"
-#include <map>
+#include "unostrategy.h"
+#include "rng.h"
+#include "unolog.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <random>
 #include <algorithm>
 #include <sstream>
+#include <stdexcept>
 
 // Card member function implementations
 std::string Card::getColorString() const {
@@ -28,321 +35,430 @@ std::string Card::getValueString() const {
     return "Unknown";
 }
 
-// Node for card linked list
-struct CardNode {
-    Card card;
-    CardNode* next;
-    
-    CardNode(Card c) : card(c), next(nullptr) {}
+// Cards are stored as 1-byte ids (see Card::id)
+typedef uint8_t CardId;
+
+static const int facesPerColor = Card::facesPerColor;
+static const int numCardIds = Card::numIds;
+
+static bool isNumberId(CardId id) {
+    return id % facesPerColor <= 9;
+}
+
+// playableOn[top] has a bit for every card that may be played on top:
+// same color, or same number for number cards
+struct PlayableTable {
+    uint64_t playableOn[numCardIds];
+
+    PlayableTable() {
+        for (int top = 0; top < numCardIds; top++) {
+            uint64_t mask = 0;
+            for (int id = 0; id < numCardIds; id++) {
+                bool sameColor = id / facesPerColor == top / facesPerColor;
+                bool sameNumber = isNumberId(id) && isNumberId(top) &&
+                                  id % facesPerColor == top % facesPerColor;
+                if (sameColor || sameNumber) {
+                    mask |= 1ull << id;
+                }
+            }
+            playableOn[top] = mask;
+        }
+    }
+};
+
+static const PlayableTable playable;
+
+// The unshuffled deck: per color one 0, two of each 1-9 and two of each
+// action card, listed last-created first as the original linked-list deck
+// was, so a given generator still deals the same cards
+struct StandardDeck {
+    CardId cards[UNOGame::deckCapacity];
+
+    StandardDeck() {
+        int n = UNOGame::deckCapacity;
+        for (int color = 0; color < 4; color++) {
+            int base = color * facesPerColor;
+            cards[--n] = static_cast<CardId>(base);
+            for (int face = 1; face < facesPerColor; face++) {
+                cards[--n] = static_cast<CardId>(base + face);
+                cards[--n] = static_cast<CardId>(base + face);
+            }
+        }
+    }
 };
 
-// Player structure
+static const StandardDeck standardDeck;
+
+// A hand as two masks. The deck holds at most two copies of any card, so
+// "at least one" and "both" copies are enough to count every id.
 struct Player {
-    CardNode* hand;
+    uint64_t cards;    // Bit set when holding at least one copy
+    uint64_t doubles;  // Bit set when holding both copies
     int cardCount;
     
-    Player() : hand(nullptr), cardCount(0) {}
+    Player() : cards(0), doubles(0), cardCount(0) {}
     
-    ~Player() {
-        while (hand) {
-            CardNode* temp = hand;
-            hand = hand->next;
-            delete temp;
+    void addCard(CardId id) {
+        uint64_t bit = 1ull << id;
+        if (cards & bit) {
+            doubles |= bit;
+        } else {
+            cards |= bit;
         }
-    }
-    
-    void addCard(Card card) {
-        CardNode* newNode = new CardNode(card);
-        newNode->next = hand;
-        hand = newNode;
         cardCount++;
     }
     
-    bool removeCard(CardNode* prev, CardNode* node) {
-        if (prev) {
-            prev->next = node->next;
+    void removeCard(CardId id) {
+        uint64_t bit = 1ull << id;
+        if (doubles & bit) {
+            doubles &= ~bit;
         } else {
-            hand = node->next;
+            cards &= ~bit;
         }
-        delete node;
         cardCount--;
-        return true;
     }
 };
 
+typedef std::chrono::steady_clock Clock;
+
+// Counters have a single writer, the thread playing the game, so a relaxed
+// load and store is enough; it compiles to a plain increment, with no
+// locked read-modify-write on the hot path
+static inline void bump(std::atomic<uint64_t>& counter, uint64_t by = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+}
+
 // Game data structure
 class GameData {
 public:
     int numPlayers;
-    std::vector<Player*> players;
-    CardNode* deck;
-    CardNode* discardPile;
+    Player players[UNOGame::maxPlayers];
+    CardId deck[UNOGame::deckCapacity];  // Draw pile
+    int drawIndex;               // Next card to draw; the deck is empty at deckCapacity
+    CardId topCard;              // Top of the discard pile
+    int discardCount;
     int currentPlayer;
     bool clockwise;
-    int deckSize;
+    int turnCount;
+    int playCounts[4];      // Cards played, by Card::Type
     
-    GameData(int n) : numPlayers(n), deck(nullptr), discardPile(nullptr), 
-                      currentPlayer(0), clockwise(true), deckSize(0) {
-        for (int i = 0; i < numPlayers; i++) {
-            players.push_back(new Player());
+    // Event log (unolog.h): events are batched in eventBuffer
+    EventSink* sink;
+    uint8_t eventBuffer[512];
+    int eventBytes;
+    uint64_t dealSeed;      // Seed of the current deal, if seeded
+    bool seededDeal;
+    
+    // Turn timing (setTurnTiming)
+    int timingEvery;        // 0 when off
+    int timingCountdown;    // Turns until the next timed one
+    bool timingTurn;        // The current turn is being timed
+    Clock::time_point turnStart;
+    
+    // Lifetime counters (GameCounters). Only the playing thread writes
+    // them, with relaxed stores, so any thread may read them at any time.
+    // They are not on a cache line of their own, and turnsPlayed and
+    // cardsDrawn change every turn, so a reader polling them does pull
+    // lines the playing thread is writing
+    std::atomic<uint64_t> gamesDealt;
+    std::atomic<uint64_t> gamesWon;
+    std::atomic<uint64_t> turnsPlayed;
+    std::atomic<uint64_t> cardsDrawn;
+    std::atomic<uint64_t> deckExhausted;
+    std::atomic<uint64_t> timedTurns;
+    std::atomic<uint64_t> turnLatency[GameCounters::latencyBuckets];
+    
+    GameData(int n) : numPlayers(n), drawIndex(UNOGame::deckCapacity),
+                      topCard(0), discardCount(0), currentPlayer(0), clockwise(true),
+                      turnCount(0), playCounts(), sink(nullptr), eventBytes(0),
+                      dealSeed(0), seededDeal(false), timingEvery(0), timingCountdown(0),
+                      timingTurn(false), gamesDealt(0), gamesWon(0), turnsPlayed(0),
+                      cardsDrawn(0), deckExhausted(0), timedTurns(0) {
+        for (std::atomic<uint64_t>& bucket : turnLatency) {
+            bucket.store(0, std::memory_order_relaxed);
         }
     }
     
-    ~GameData() {
-        for (Player* p : players) {
-            delete p;
+    // Return to the state of a new game, before the deck is filled
+    void clear() {
+        for (Player& player : players) {
+            player = Player();
         }
-        while (deck) {
-            CardNode* temp = deck;
-            deck = deck->next;
-            delete temp;
+        drawIndex = UNOGame::deckCapacity;
+        topCard = 0;
+        discardCount = 0;
+        currentPlayer = 0;
+        clockwise = true;
+        turnCount = 0;
+        std::memset(playCounts, 0, sizeof(playCounts));
+        seededDeal = false;
+    }
+    
+    bool deckEmpty() const {
+        return drawIndex >= UNOGame::deckCapacity;
+    }
+    
+    CardId drawFromDeck() {
+        if (deckEmpty()) {
+            // If deck is empty, return a dummy card (Red 0). Callers check
+            // deckEmpty first; count it in case one does not.
+            bump(deckExhausted);
+            return 0;
         }
-        while (discardPile) {
-            CardNode* temp = discardPile;
-            discardPile = discardPile->next;
-            delete temp;
+        return deck[drawIndex++];
+    }
+    
+    void addToDiscard(CardId card) {
+        topCard = card;
+        discardCount++;
+        playCounts[Card::fromId(card).type]++;
+    }
+    
+    void flushEvents() {
+        if (eventBytes > 0) {
+            sink->write(eventBuffer, eventBytes);
+            eventBytes = 0;
+        }
+    }
+    
+    // Append one event; only called while sink is set
+    void logEvent(int type, int seat, int flags = 0) {
+        if (eventBytes + GameEvent::maxSize > static_cast<int>(sizeof(eventBuffer))) {
+            flushEvents();
         }
+        eventBuffer[eventBytes++] = static_cast<uint8_t>(type | seat << 3 | flags);
     }
     
-    void addCardToDeck(Card card) {
-        CardNode* newNode = new CardNode(card);
-        newNode->next = deck;
-        deck = newNode;
-        deckSize++;
+    void logEvent(int type, int seat, int flags, CardId card) {
+        logEvent(type, seat, flags);
+        eventBuffer[eventBytes++] = card;
     }
     
-    Card drawFromDeck() {
-        if (!deck) {
-            // If deck is empty, return a dummy card
-            return Card(Card::RED, Card::NUMBER, 0);
+    void logDeal() {
+        if (seededDeal) {
+            logEvent(GameEvent::DEAL, numPlayers - 1);
+            for (int i = 0; i < 8; i++) {
+                eventBuffer[eventBytes++] = static_cast<uint8_t>(dealSeed >> (8 * i));
+            }
+        } else {
+            logEvent(GameEvent::DEAL, numPlayers - 1, GameEvent::deckFlag);
+            std::memcpy(eventBuffer + eventBytes, deck, UNOGame::deckCapacity);
+            eventBytes += UNOGame::deckCapacity;
         }
-        CardNode* temp = deck;
-        Card card = deck->card;
-        deck = deck->next;
-        delete temp;
-        deckSize--;
-        return card;
     }
     
-    void addToDiscard(Card card) {
-        CardNode* newNode = new CardNode(card);
-        newNode->next = discardPile;
-        discardPile = newNode;
+    // End of a timed turn: add its duration to the histogram
+    void finishTimedTurn() {
+        timingTurn = false;
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - turnStart).count();
+        int bucket = ns ? 63 - __builtin_clzll(ns) : 0;
+        bump(turnLatency[std::min(bucket, GameCounters::latencyBuckets - 1)]);
+        bump(timedTurns);
     }
     
-    Card getTopCard() const {
-        return discardPile->card;
+    void advance(int steps) {
+        if (clockwise) {
+            currentPlayer = (currentPlayer + steps) % numPlayers;
+        } else {
+            currentPlayer = (currentPlayer - steps + numPlayers) % numPlayers;
+        }
     }
 };
 
-// Global storage
-static std::map<size_t, GameData*> gameStorage;
-static size_t nextGameId = 1;
+static void checkPlayerCount(int numPlayers) {
+    if (numPlayers < 2 || numPlayers > UNOGame::maxPlayers) {
+        throw std::invalid_argument("UNOGame needs 2-4 players");
+    }
+}
 
-static size_t& getGameId(const UNOGame* game) {
-    return *((size_t*)game);
+UNOGame::UNOGame(int numPlayers) {
+    checkPlayerCount(numPlayers);
+    data = new GameData(numPlayers);
 }
 
-static GameData* getGameData(const UNOGame* game) {
-    size_t id = getGameId(game);
-    if (id == 0 || gameStorage.find(id) == gameStorage.end()) {
-        return nullptr;
+UNOGame::~UNOGame() {
+    if (data->sink) {
+        data->flushEvents();
     }
-    return gameStorage[id];
+    delete data;
 }
 
-UNOGame::UNOGame(int numPlayers) {
-    size_t id = nextGameId++;
-    getGameId(this) = id;
-    gameStorage[id] = new GameData(numPlayers);
+void UNOGame::initialize() {
+    std::mt19937 rng(1234);
+    initializeWith(rng);
 }
 
-void UNOGame::initialize() {
-    GameData* data = getGameData(this);
-    
-    // Create deck (76 cards total)
-    for (int color = 0; color < 4; color++) {
-        Card::Color c = static_cast<Card::Color>(color);
-        
-        // One 0 per color
-        data->addCardToDeck(Card(c, Card::NUMBER, 0));
-        
-        // Two of each 1-9
-        for (int num = 1; num <= 9; num++) {
-            data->addCardToDeck(Card(c, Card::NUMBER, num));
-            data->addCardToDeck(Card(c, Card::NUMBER, num));
-        }
-        
-        // Two Skip per color
-        data->addCardToDeck(Card(c, Card::SKIP, -1));
-        data->addCardToDeck(Card(c, Card::SKIP, -1));
-        
-        // Two Reverse per color
-        data->addCardToDeck(Card(c, Card::REVERSE, -1));
-        data->addCardToDeck(Card(c, Card::REVERSE, -1));
-        
-        // Two Draw Two per color
-        data->addCardToDeck(Card(c, Card::DRAW_TWO, -1));
-        data->addCardToDeck(Card(c, Card::DRAW_TWO, -1));
+void UNOGame::initialize(uint64_t seed) {
+    // Fisher-Yates with a multiply-shift bounded draw: one generator call
+    // and no division per card
+    Xoshiro256 rng(seed);
+    uint8_t* cards = resetDeck();
+    for (uint64_t i = deckCapacity - 1; i > 0; i--) {
+        uint64_t j = uniformBelow(rng, i + 1);
+        std::swap(cards[i], cards[j]);
     }
-    
-    // Shuffle deck with seed 1234
-    std::vector<Card> tempDeck;
-    CardNode* current = data->deck;
-    while (current) {
-        tempDeck.push_back(current->card);
-        current = current->next;
-    }
-    
-    std::mt19937 rng(1234);
-    std::shuffle(tempDeck.begin(), tempDeck.end(), rng);
-    
-    // Clear old deck
-    while (data->deck) {
-        CardNode* temp = data->deck;
-        data->deck = data->deck->next;
-        delete temp;
-    }
-    data->deck = nullptr;
-    data->deckSize = 0;
-    
-    // Rebuild deck from shuffled cards
-    for (int i = tempDeck.size() - 1; i >= 0; i--) {
-        data->addCardToDeck(tempDeck[i]);
+    data->dealSeed = seed;
+    data->seededDeal = true;
+    deal();
+}
+
+void UNOGame::reset(uint64_t seed, int numPlayers) {
+    checkPlayerCount(numPlayers);
+    data->numPlayers = numPlayers;
+    initialize(seed);
+}
+
+uint8_t* UNOGame::resetDeck() {
+    data->clear();
+    std::memcpy(data->deck, standardDeck.cards, sizeof(data->deck));
+    data->drawIndex = 0;
+    return data->deck;
+}
+
+void UNOGame::deal() {
+    bump(data->gamesDealt);
+    if (data->sink) {
+        data->logDeal();
     }
     
     // Deal 7 cards to each player
     for (int i = 0; i < 7; i++) {
         for (int p = 0; p < data->numPlayers; p++) {
-            Card card = data->drawFromDeck();
-            data->players[p]->addCard(card);
+            data->players[p].addCard(data->drawFromDeck());
         }
     }
     
     // Place top card on discard pile
-    Card topCard = data->drawFromDeck();
-    data->addToDiscard(topCard);
+    data->topCard = data->drawFromDeck();
+    data->discardCount = 1;
 }
 
 void UNOGame::playTurn() {
-    GameData* data = getGameData(this);
-    Player* player = data->players[data->currentPlayer];
-    Card topCard = data->getTopCard();
+    FirstPlayableStrategy strategy;
+    playTurn(strategy);
+}
+
+bool UNOGame::beginTurn(TurnView& view) {
+    data->turnCount++;
+    bump(data->turnsPlayed);
+    if (data->timingEvery && --data->timingCountdown <= 0) {
+        data->timingCountdown = data->timingEvery;
+        data->timingTurn = true;
+        data->turnStart = Clock::now();
+    }
+    const Player& player = data->players[data->currentPlayer];
     
-    // Find a playable card
-    CardNode* current = player->hand;
-    CardNode* prev = nullptr;
-    CardNode* playableCard = nullptr;
-    CardNode* playablePrev = nullptr;
+    // Playable cards: one AND of the hand with the top card's match mask
+    view.playable = player.cards & playable.playableOn[data->topCard];
+    if (!view.playable) {
+        return false;
+    }
+    
+    view.hand = player.cards;
+    view.handDoubles = player.doubles;
+    view.topCard = data->topCard;
+    view.player = data->currentPlayer;
+    view.numPlayers = data->numPlayers;
+    view.clockwise = data->clockwise;
+    for (int i = 0; i < maxPlayers; i++) {
+        view.cardCounts[i] = data->players[i].cardCount;
+    }
+    view.deckSize = deckCapacity - data->drawIndex;
+    return true;
+}
+
+// Event type for playing each Card::Type
+static const int playEvent[4] = {
+    GameEvent::PLAY, GameEvent::SKIP, GameEvent::REVERSE, GameEvent::DRAW_TWO
+};
+
+void UNOGame::playCard(uint8_t played) {
+    Player& player = data->players[data->currentPlayer];
+    player.removeCard(played);
+    data->addToDiscard(played);
     
-    // Priority: color match, value match, action card
-    while (current) {
-        bool canPlay = false;
+    // Handle action cards
+    Card::Type type = Card::fromId(played).type;
+    if (data->sink) {
+        data->logEvent(playEvent[type], data->currentPlayer, 0, played);
+    }
+    int steps = 1;
+    if (type == Card::SKIP) {
+        // Skip next player - move twice
+        steps = 2;
+    } else if (type == Card::REVERSE) {
+        data->clockwise = !data->clockwise;
+    } else if (type == Card::DRAW_TWO) {
+        // Next player draws 2 and skips
+        int nextPlayer = data->clockwise ? 
+            (data->currentPlayer + 1) % data->numPlayers :
+            (data->currentPlayer - 1 + data->numPlayers) % data->numPlayers;
         
-        // Color match
-        if (current->card.color == topCard.color) {
-            canPlay = true;
+        int given = 0;
+        for (; given < 2 && !data->deckEmpty(); given++) {
+            CardId drawn = data->drawFromDeck();
+            data->players[nextPlayer].addCard(drawn);
+            if (data->sink) {
+                data->logEvent(GameEvent::DRAW, nextPlayer, GameEvent::forcedFlag, drawn);
+            }
         }
-        // Value match (for number cards)
-        else if (current->card.type == Card::NUMBER && topCard.type == Card::NUMBER &&
-                 current->card.value == topCard.value) {
-            canPlay = true;
+        bump(data->cardsDrawn, given);
+        if (given < 2) {
+            bump(data->deckExhausted, 2 - given);
         }
         
-        if (canPlay && !playableCard) {
-            playableCard = current;
-            playablePrev = prev;
+        // Skip that player
+        steps = 2;
+    }
+    
+    if (player.cardCount == 0) {
+        bump(data->gamesWon);
+        if (data->sink) {
+            data->logEvent(GameEvent::WIN, data->currentPlayer);
+            data->flushEvents();
         }
-        
-        prev = current;
-        current = current->next;
     }
     
-    if (playableCard) {
-        // Play the card
-        Card played = playableCard->card;
-        player->removeCard(playablePrev, playableCard);
-        data->addToDiscard(played);
-        
-        // Handle action cards
-        if (played.type == Card::SKIP) {
-            // Skip next player - move twice
-            if (data->clockwise) {
-                data->currentPlayer = (data->currentPlayer + 2) % data->numPlayers;
-            } else {
-                data->currentPlayer = (data->currentPlayer - 2 + data->numPlayers) % data->numPlayers;
-            }
-            return;
-        } else if (played.type == Card::REVERSE) {
-            data->clockwise = !data->clockwise;
-        } else if (played.type == Card::DRAW_TWO) {
-            // Next player draws 2 and skips
-            int nextPlayer = data->clockwise ? 
-                (data->currentPlayer + 1) % data->numPlayers :
-                (data->currentPlayer - 1 + data->numPlayers) % data->numPlayers;
-            
-            if (data->deck) {
-                data->players[nextPlayer]->addCard(data->drawFromDeck());
-            }
-            if (data->deck) {
-                data->players[nextPlayer]->addCard(data->drawFromDeck());
-            }
-            
-            // Skip that player
-            if (data->clockwise) {
-                data->currentPlayer = (data->currentPlayer + 2) % data->numPlayers;
-            } else {
-                data->currentPlayer = (data->currentPlayer - 2 + data->numPlayers) % data->numPlayers;
-            }
-            return;
+    // Move to next player
+    data->advance(steps);
+    if (data->timingTurn) {
+        data->finishTimedTurn();
+    }
+}
+
+void UNOGame::drawTurn() {
+    // No playable card - draw one, and play it at once if it matches
+    if (!data->deckEmpty()) {
+        CardId drawn = data->drawFromDeck();
+        bump(data->cardsDrawn);
+        bool matches = playable.playableOn[data->topCard] & (1ull << drawn);
+        if (matches) {
+            data->addToDiscard(drawn);
+        } else {
+            data->players[data->currentPlayer].addCard(drawn);
+        }
+        if (data->sink) {
+            data->logEvent(GameEvent::DRAW, data->currentPlayer,
+                           matches ? GameEvent::playedFlag : 0, drawn);
         }
     } else {
-        // No playable card - draw one
-        if (data->deck) {
-            Card drawn = data->drawFromDeck();
-            player->addCard(drawn);
-            
-            // Check if drawn card is playable
-            bool canPlayDrawn = false;
-            if (drawn.color == topCard.color) {
-                canPlayDrawn = true;
-            } else if (drawn.type == Card::NUMBER && topCard.type == Card::NUMBER &&
-                       drawn.value == topCard.value) {
-                canPlayDrawn = true;
-            }
-            
-            // If playable, play it immediately
-            if (canPlayDrawn) {
-                // Find and remove the card we just added
-                current = player->hand;
-                prev = nullptr;
-                while (current) {
-                    if (current->card.color == drawn.color && 
-                        current->card.type == drawn.type && 
-                        current->card.value == drawn.value) {
-                        player->removeCard(prev, current);
-                        data->addToDiscard(drawn);
-                        break;
-                    }
-                    prev = current;
-                    current = current->next;
-                }
-            }
+        bump(data->deckExhausted);
+        if (data->sink) {
+            data->logEvent(GameEvent::DRAW, data->currentPlayer, GameEvent::emptyFlag);
         }
     }
     
     // Move to next player
-    if (data->clockwise) {
-        data->currentPlayer = (data->currentPlayer + 1) % data->numPlayers;
-    } else {
-        data->currentPlayer = (data->currentPlayer - 1 + data->numPlayers) % data->numPlayers;
+    data->advance(1);
+    if (data->timingTurn) {
+        data->finishTimedTurn();
     }
 }
 
 bool UNOGame::isGameOver() const {
-    GameData* data = getGameData(this);
-    for (Player* player : data->players) {
-        if (player->cardCount == 0) {
+    for (int i = 0; i < data->numPlayers; i++) {
+        if (data->players[i].cardCount == 0) {
             return true;
         }
     }
@@ -350,9 +466,8 @@ bool UNOGame::isGameOver() const {
 }
 
 int UNOGame::getWinner() const {
-    GameData* data = getGameData(this);
     for (int i = 0; i < data->numPlayers; i++) {
-        if (data->players[i]->cardCount == 0) {
+        if (data->players[i].cardCount == 0) {
             return i;
         }
     }
@@ -360,22 +475,116 @@ int UNOGame::getWinner() const {
 }
 
 std::string UNOGame::getState() const {
-    GameData* data = getGameData(this);
     std::ostringstream oss;
     
     oss << "Player " << data->currentPlayer << "'s turn, ";
     oss << "Direction: " << (data->clockwise ? "Clockwise" : "Counter-clockwise") << ", ";
     
-    Card topCard = data->getTopCard();
+    Card topCard = Card::fromId(data->topCard);
     oss << "Top: " << topCard.getColorString() << " " << topCard.getValueString() << ", ";
     
     oss << "Players cards: ";
     for (int i = 0; i < data->numPlayers; i++) {
-        oss << "P" << i << ":" << data->players[i]->cardCount;
+        oss << "P" << i << ":" << data->players[i].cardCount;
         if (i < data->numPlayers - 1) {
             oss << ", ";
         }
     }
     
     return oss.str();
-}
\ No newline at end of file
+}
+
+GameSummary UNOGame::getSummary() const {
+    GameSummary summary;
+    for (int i = 0; i < maxPlayers; i++) {
+        summary.cardCounts[i] = static_cast<uint8_t>(data->players[i].cardCount);
+    }
+    summary.topCard = data->topCard;
+    summary.numPlayers = static_cast<uint8_t>(data->numPlayers);
+    summary.currentPlayer = static_cast<uint8_t>(data->currentPlayer);
+    summary.clockwise = data->clockwise;
+    summary.deckSize = static_cast<uint8_t>(deckCapacity - data->drawIndex);
+    summary.winner = static_cast<int8_t>(getWinner());
+    summary.turnCount = data->turnCount;
+    return summary;
+}
+
+GameCounters UNOGame::getCounters() const {
+    GameCounters counters;
+    counters.gamesDealt = data->gamesDealt.load(std::memory_order_relaxed);
+    counters.gamesWon = data->gamesWon.load(std::memory_order_relaxed);
+    counters.turnsPlayed = data->turnsPlayed.load(std::memory_order_relaxed);
+    counters.cardsDrawn = data->cardsDrawn.load(std::memory_order_relaxed);
+    counters.deckExhausted = data->deckExhausted.load(std::memory_order_relaxed);
+    counters.timedTurns = data->timedTurns.load(std::memory_order_relaxed);
+    for (int i = 0; i < GameCounters::latencyBuckets; i++) {
+        counters.turnLatency[i] = data->turnLatency[i].load(std::memory_order_relaxed);
+    }
+    return counters;
+}
+
+void UNOGame::setTurnTiming(int sampleEvery) {
+    data->timingEvery = std::max(sampleEvery, 0);
+    data->timingCountdown = data->timingEvery;
+    data->timingTurn = false;
+}
+
+GameState UNOGame::saveState() const {
+    static_assert(sizeof(GameState::hands) / sizeof(uint64_t) == maxPlayers &&
+                  sizeof(GameState::deck) == deckCapacity, "GameState size mismatch");
+    GameState state;
+    for (int i = 0; i < maxPlayers; i++) {
+        state.hands[i] = data->players[i].cards;
+        state.handDoubles[i] = data->players[i].doubles;
+        state.cardCounts[i] = static_cast<uint8_t>(data->players[i].cardCount);
+    }
+    std::memcpy(state.deck, data->deck, sizeof(state.deck));
+    state.drawIndex = static_cast<uint8_t>(data->drawIndex);
+    state.topCard = data->topCard;
+    state.numPlayers = static_cast<uint8_t>(data->numPlayers);
+    state.currentPlayer = static_cast<uint8_t>(data->currentPlayer);
+    state.clockwise = data->clockwise;
+    return state;
+}
+
+void UNOGame::loadState(const GameState& state) {
+    data->clear();
+    for (int i = 0; i < maxPlayers; i++) {
+        data->players[i].cards = state.hands[i];
+        data->players[i].doubles = state.handDoubles[i];
+        data->players[i].cardCount = state.cardCounts[i];
+    }
+    std::memcpy(data->deck, state.deck, sizeof(state.deck));
+    data->drawIndex = state.drawIndex;
+    data->topCard = state.topCard;
+    data->discardCount = 1;
+    data->numPlayers = state.numPlayers;
+    data->currentPlayer = state.currentPlayer;
+    data->clockwise = state.clockwise;
+}
+
+uint64_t UNOGame::playableOn(uint8_t topCard) {
+    return playable.playableOn[topCard];
+}
+
+int UNOGame::getTurnCount() const {
+    return data->turnCount;
+}
+
+int UNOGame::getPlayCount(Card::Type type) const {
+    return data->playCounts[type];
+}
+
+void UNOGame::setEventSink(EventSink* sink) {
+    if (data->sink) {
+        data->flushEvents();
+    }
+    data->sink = sink;
+}
+
+void UNOGame::flushEvents() {
+    if (data->sink) {
+        data->flushEvents();
+        data->sink->flush();
+    }
+}
@@ -0,0 +1,288 @@
+#include "unobatch.h"
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+// Build the turn loop for AVX-512 and AVX2 as well as the baseline and pick
+// one at load time, so the vector path does not depend on -march flags.
+// target_clones only picks the instruction set: the loop vectorizer is
+// switched on for the kernel too, with the cost model -O3 uses, and the
+// per-seat loops are unrolled by pragma, so it vectorizes at -O2 as well.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define VECTOR_CLONES __attribute__((target_clones("avx512f", "avx2", "default"), \
+                                     optimize("tree-loop-vectorize", "vect-cost-model=dynamic")))
+#elif defined(__GNUC__) && !defined(__clang__)
+#define VECTOR_CLONES __attribute__((optimize("tree-loop-vectorize", "vect-cost-model=dynamic")))
+#else
+#define VECTOR_CLONES
+#endif
+
+// Games per tile; a full tile is about 60 KB, so it stays in L2
+static const int tileSize = 256;
+
+// One tile of games in flight, one lane per game. Every per-lane value is
+// 64 bits wide so the same vector width covers every array in the turn loop.
+struct Tile {
+    uint64_t hands[UNOGame::maxPlayers][tileSize];
+    uint64_t doubles[UNOGame::maxPlayers][tileSize];
+    uint64_t topCard[tileSize];
+    uint64_t currentPlayer[tileSize];
+    uint64_t clockwise[tileSize];       // 1 or 0
+    uint64_t drawIndex[tileSize];
+    uint64_t matches[tileSize];         // Cards playable on topCard
+    uint64_t nextCards[2][tileSize];    // deck[drawIndex] and deck[drawIndex + 1]
+    uint64_t nextBits[2][tileSize];     // The same cards as masks
+    uint64_t won[tileSize];             // Winning seat + 1, or 0
+    // Two bytes of padding so both next cards can be read at any drawIndex
+    uint8_t decks[tileSize][UNOGame::deckCapacity + 2];
+    int games[tileSize];                // Batch index of each lane
+    int live;                           // Lanes [0, live) hold running games
+};
+
+static inline uint64_t maskIf(uint64_t condition) {
+    return 0 - condition;
+}
+
+static inline uint64_t select(uint64_t mask, uint64_t a, uint64_t b) {
+    return (a & mask) | (b & ~mask);
+}
+
+// Index of the lowest set bit for masks below 2^52, without a bit-scan
+// instruction so the loop vectorizes: isolate the bit, place it in the
+// mantissa of 2^52 and read the exponent of the difference
+static inline uint64_t lowestCardId(uint64_t mask) {
+    uint64_t low = mask & (0 - mask);
+    uint64_t bits = low | 0x4330000000000000ull;
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    value -= 4503599627370496.0;  // 2^52
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits >> 52) - 1023;
+}
+
+// Card masks shared by every batch
+struct CardMasks {
+    uint64_t on[Card::numIds];   // UNOGame::playableOn for each top card
+
+    CardMasks() {
+        for (int id = 0; id < Card::numIds; id++) {
+            on[id] = UNOGame::playableOn(static_cast<uint8_t>(id));
+        }
+    }
+};
+
+// Built on first use: UNOGame::playableOn reads a table from another
+// translation unit, which may not be constructed yet during static init
+static const CardMasks& cardMasks() {
+    static const CardMasks instance;
+    return instance;
+}
+
+static void loadLane(Tile& tile, int lane, const GameState& state, int game) {
+    for (int p = 0; p < UNOGame::maxPlayers; p++) {
+        tile.hands[p][lane] = state.hands[p];
+        tile.doubles[p][lane] = state.handDoubles[p];
+    }
+    tile.topCard[lane] = state.topCard;
+    tile.currentPlayer[lane] = state.currentPlayer;
+    tile.clockwise[lane] = state.clockwise;
+    tile.drawIndex[lane] = state.drawIndex;
+    tile.won[lane] = 0;
+    std::memcpy(tile.decks[lane], state.deck, UNOGame::deckCapacity);
+    tile.decks[lane][UNOGame::deckCapacity] = 0;
+    tile.decks[lane][UNOGame::deckCapacity + 1] = 0;
+    tile.games[lane] = game;
+}
+
+static void storeLane(const Tile& tile, int lane, GameState& state) {
+    for (int p = 0; p < UNOGame::maxPlayers; p++) {
+        state.hands[p] = tile.hands[p][lane];
+        state.handDoubles[p] = tile.doubles[p][lane];
+        state.cardCounts[p] = static_cast<uint8_t>(__builtin_popcountll(state.hands[p]) +
+                                                   __builtin_popcountll(state.handDoubles[p]));
+    }
+    std::memcpy(state.deck, tile.decks[lane], UNOGame::deckCapacity);
+    state.drawIndex = static_cast<uint8_t>(tile.drawIndex[lane]);
+    state.topCard = static_cast<uint8_t>(tile.topCard[lane]);
+    state.currentPlayer = static_cast<uint8_t>(tile.currentPlayer[lane]);
+    state.clockwise = tile.clockwise[lane] != 0;
+}
+
+static void moveLane(Tile& tile, int from, int to) {
+    for (int p = 0; p < UNOGame::maxPlayers; p++) {
+        tile.hands[p][to] = tile.hands[p][from];
+        tile.doubles[p][to] = tile.doubles[p][from];
+    }
+    tile.topCard[to] = tile.topCard[from];
+    tile.currentPlayer[to] = tile.currentPlayer[from];
+    tile.clockwise[to] = tile.clockwise[from];
+    tile.drawIndex[to] = tile.drawIndex[from];
+    tile.won[to] = tile.won[from];
+    std::memcpy(tile.decks[to], tile.decks[from], sizeof(tile.decks[to]));
+    tile.games[to] = tile.games[from];
+}
+
+// Gather stage of a turn: the table and deck lookups of every lane, done
+// up front so the turn loop itself is pure arithmetic. Variable shifts of a
+// constant stay out of the turn loop too, since GCC will not vectorize them.
+static void gatherLanes(Tile& tile) {
+    const CardMasks& masks = cardMasks();
+    for (int i = 0; i < tile.live; i++) {
+        const uint8_t* deck = tile.decks[i] + tile.drawIndex[i];
+        tile.matches[i] = masks.on[tile.topCard[i]];
+        tile.nextCards[0][i] = deck[0];
+        tile.nextCards[1][i] = deck[1];
+        tile.nextBits[0][i] = 1ull << deck[0];
+        tile.nextBits[1][i] = 1ull << deck[1];
+    }
+}
+
+// Play one turn in every live lane, following UNOGame::playCard and
+// UNOGame::drawTurn with masks and selects in place of branches. Returns
+// nonzero if any lane won.
+VECTOR_CLONES
+static uint64_t playTurns(Tile& tile, uint64_t numPlayers) {
+    const uint64_t deckEnd = UNOGame::deckCapacity;
+    uint64_t anyWon = 0;
+
+    for (int i = 0; i < tile.live; i++) {
+        uint64_t player = tile.currentPlayer[i];
+        uint64_t drawPos = tile.drawIndex[i];
+        uint64_t matches = tile.matches[i];
+
+        uint64_t hand = 0, dbl = 0;
+#pragma GCC unroll 4
+        for (int p = 0; p < UNOGame::maxPlayers; p++) {
+            uint64_t seat = maskIf(player == static_cast<uint64_t>(p));
+            hand |= tile.hands[p][i] & seat;
+            dbl |= tile.doubles[p][i] & seat;
+        }
+
+        // Play the lowest playable id, if any
+        uint64_t playable = hand & matches;
+        uint64_t plays = maskIf(playable != 0);
+        uint64_t playBit = playable & (0 - playable);
+        uint64_t card = lowestCardId(playable);
+        uint64_t isSkip = maskIf((playBit & Card::skipCards) != 0);
+        uint64_t isReverse = maskIf((playBit & Card::reverseCards) != 0);
+        uint64_t isDrawTwo = maskIf((playBit & Card::drawTwoCards) != 0);
+
+        // Otherwise draw one card if the deck has any; play it at once if
+        // it matches, else keep it
+        uint64_t drawnBit = tile.nextBits[0][i];
+        uint64_t draws = ~plays & maskIf(drawPos < deckEnd);
+        uint64_t drawnPlays = draws & maskIf((matches & drawnBit) != 0);
+        uint64_t keepBit = drawnBit & draws & ~drawnPlays;
+        drawPos += draws & 1;
+
+        uint64_t twice = dbl & playBit;
+        dbl ^= twice;
+        hand ^= playBit & ~twice;
+        dbl |= hand & keepBit;
+        hand |= keepBit;
+        tile.topCard[i] = select(plays, card, select(drawnPlays, tile.nextCards[0][i], tile.topCard[i]));
+
+        // Turn order
+        uint64_t clockwise = tile.clockwise[i] ^ (isReverse & 1);
+        uint64_t steps = 1 + ((isSkip | isDrawTwo) & 1);
+        uint64_t next = select(maskIf(clockwise), player + steps, player + numPlayers - steps);
+        next -= numPlayers & maskIf(next >= numPlayers);
+        uint64_t victim = select(maskIf(clockwise), player + 1, player + numPlayers - 1);
+        victim -= numPlayers & maskIf(victim >= numPlayers);
+
+        // Draw Two: the next seat takes up to two cards (drawPos is
+        // unchanged by a turn that plays, so they are the gathered cards)
+        uint64_t give0 = isDrawTwo & maskIf(drawPos < deckEnd);
+        uint64_t give1 = isDrawTwo & maskIf(drawPos + 1 < deckEnd);
+        uint64_t giveBit0 = tile.nextBits[0][i] & give0;
+        uint64_t giveBit1 = tile.nextBits[1][i] & give1;
+        drawPos += (give0 & 1) + (give1 & 1);
+
+#pragma GCC unroll 4
+        for (int p = 0; p < UNOGame::maxPlayers; p++) {
+            uint64_t seat = maskIf(player == static_cast<uint64_t>(p));
+            uint64_t target = isDrawTwo & maskIf(victim == static_cast<uint64_t>(p));
+            uint64_t seatHand = tile.hands[p][i];
+            uint64_t seatDbl = tile.doubles[p][i];
+            seatDbl |= seatHand & giveBit0;
+            seatHand |= giveBit0;
+            seatDbl |= seatHand & giveBit1;
+            seatHand |= giveBit1;
+            tile.hands[p][i] = select(seat, hand, select(target, seatHand, tile.hands[p][i]));
+            tile.doubles[p][i] = select(seat, dbl, select(target, seatDbl, tile.doubles[p][i]));
+        }
+
+        tile.currentPlayer[i] = next;
+        tile.clockwise[i] = clockwise;
+        tile.drawIndex[i] = drawPos;
+
+        uint64_t won = plays & maskIf(hand == 0) & (player + 1);
+        tile.won[i] = won;
+        anyWon |= won;
+    }
+    return anyWon;
+}
+
+UNOBatch::UNOBatch(int games, int players)
+    : numGames(games), numPlayers(players), states(games), winner(games, -1), turns(games) {
+    if (players < 2 || players > UNOGame::maxPlayers) {
+        throw std::invalid_argument("UNOBatch needs 2-4 players");
+    }
+}
+
+void UNOBatch::deal(const uint64_t* seeds) {
+    // Deal through the scalar engine so both start from identical positions
+    UNOGame game(numPlayers);
+    for (int i = 0; i < numGames; i++) {
+        game.initialize(seeds[i]);
+        states[i] = game.saveState();
+        winner[i] = -1;
+        turns[i] = 0;
+    }
+}
+
+void UNOBatch::run(int maxTurns) {
+    std::unique_ptr<Tile> tile(new Tile);
+    int next = 0;
+
+    while (next < numGames) {
+        // Fill a tile with unfinished games
+        tile->live = 0;
+        for (; next < numGames && tile->live < tileSize; next++) {
+            if (winner[next] < 0) {
+                loadLane(*tile, tile->live++, states[next], next);
+            }
+        }
+
+        int turn = 0;
+        while (turn < maxTurns && tile->live > 0) {
+            gatherLanes(*tile);
+            uint64_t anyWon = playTurns(*tile, numPlayers);
+            turn++;
+
+            // Retire winners, keeping the running lanes packed at the front
+            if (anyWon) {
+                for (int i = 0; i < tile->live;) {
+                    if (!tile->won[i]) {
+                        i++;
+                        continue;
+                    }
+                    int game = tile->games[i];
+                    storeLane(*tile, i, states[game]);
+                    winner[game] = static_cast<int8_t>(tile->won[i] - 1);
+                    turns[game] += turn;
+                    if (--tile->live != i) {
+                        moveLane(*tile, tile->live, i);
+                    }
+                }
+            }
+        }
+
+        // Games still running have reached the turn limit
+        for (int i = 0; i < tile->live; i++) {
+            int game = tile->games[i];
+            storeLane(*tile, i, states[game]);
+            turns[game] += turn;
+        }
+    }
+}
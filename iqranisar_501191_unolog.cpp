@@ -0,0 +1,216 @@
+#include "unolog.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+size_t decodeEvent(const uint8_t* data, size_t size, GameEvent& event) {
+    if (size == 0) {
+        return 0;
+    }
+    uint8_t header = data[0];
+    int type = header & 7;
+    event.type = static_cast<GameEvent::Type>(type);
+    event.seat = (header >> 3) & 3;
+    event.numPlayers = 0;
+    event.flags = header & 0xE0;
+    event.card = 0;
+    event.seed = 0;
+    event.deck = nullptr;
+
+    switch (type) {
+        case GameEvent::DEAL:
+            event.numPlayers = event.seat + 1;
+            event.seat = 0;
+            if (event.numPlayers < 2) {
+                return 0;
+            }
+            if (event.flags & GameEvent::deckFlag) {
+                if (size < 1 + static_cast<size_t>(UNOGame::deckCapacity)) return 0;
+                event.deck = data + 1;
+                return 1 + UNOGame::deckCapacity;
+            }
+            if (size < 9) return 0;
+            for (int i = 0; i < 8; i++) {
+                event.seed |= static_cast<uint64_t>(data[1 + i]) << (8 * i);
+            }
+            return 9;
+        case GameEvent::DRAW:
+            if (event.flags & GameEvent::emptyFlag) {
+                return 1;
+            }
+            break;
+        case GameEvent::PLAY:
+        case GameEvent::SKIP:
+        case GameEvent::REVERSE:
+        case GameEvent::DRAW_TWO:
+            break;
+        case GameEvent::WIN:
+            return 1;
+        default:
+            return 0;
+    }
+
+    // The rest carry the card id played or drawn
+    if (size < 2 || data[1] >= Card::numIds) {
+        return 0;
+    }
+    event.card = data[1];
+    return 2;
+}
+
+// Replays one logged turn: hands UNOGame::playTurn the logged card and
+// records whether the game agreed that this seat had to choose a card
+struct LoggedMove {
+    int seat;
+    int card;
+    bool asked;
+    bool valid;
+
+    int chooseCard(const TurnView& view) {
+        asked = true;
+        valid = view.player == seat && (view.playable & (1ull << card));
+        return card;
+    }
+};
+
+// The position UNOGame::deal leaves behind for a given deck
+static GameState dealtState(const uint8_t* deck, int numPlayers) {
+    GameState state;
+    std::memset(&state, 0, sizeof(state));
+    std::memcpy(state.deck, deck, UNOGame::deckCapacity);
+    int next = 0;
+    for (int i = 0; i < 7; i++) {
+        for (int p = 0; p < numPlayers; p++) {
+            uint64_t bit = 1ull << deck[next++];
+            state.handDoubles[p] |= state.hands[p] & bit;
+            state.hands[p] |= bit;
+            state.cardCounts[p]++;
+        }
+    }
+    state.topCard = deck[next++];
+    state.drawIndex = static_cast<uint8_t>(next);
+    state.numPlayers = static_cast<uint8_t>(numPlayers);
+    state.currentPlayer = 0;
+    state.clockwise = true;
+    return state;
+}
+
+bool replayGame(const uint8_t* log, size_t size, size_t& offset, UNOGame& game, int maxTurns) {
+    GameEvent event;
+    size_t used = decodeEvent(log + offset, size - offset, event);
+    if (used == 0 || event.type != GameEvent::DEAL) {
+        return false;
+    }
+    offset += used;
+
+    if (event.deck) {
+        for (int i = 0; i < UNOGame::deckCapacity; i++) {
+            if (event.deck[i] >= Card::numIds) return false;
+        }
+        game.loadState(dealtState(event.deck, event.numPlayers));
+    } else {
+        game.reset(event.seed, event.numPlayers);
+    }
+
+    int turns = 0;
+    while (offset < size) {
+        used = decodeEvent(log + offset, size - offset, event);
+        if (used == 0) {
+            return false;
+        }
+        if (event.type == GameEvent::DEAL) {
+            break;
+        }
+        offset += used;
+
+        // Forced draws and wins follow from the turn that caused them
+        bool forced = event.type == GameEvent::DRAW && (event.flags & GameEvent::forcedFlag);
+        if (event.type == GameEvent::WIN) {
+            if (turns < maxTurns && game.getWinner() != event.seat) return false;
+            continue;
+        }
+        if (forced || turns >= maxTurns) {
+            continue;
+        }
+
+        LoggedMove move = {event.seat, event.card, false, false};
+        game.playTurn(move);
+        turns++;
+        bool drew = event.type == GameEvent::DRAW;
+        if (move.asked == drew || (move.asked && !move.valid)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+RingBufferSink::RingBufferSink(uint8_t* buf, size_t capacity)
+    : buffer(buf), bufferSize(capacity), start(0), used(0), dropped(0) {}
+
+void RingBufferSink::write(const uint8_t* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    if (size > bufferSize - used) {
+        dropped += size;
+        return;
+    }
+    size_t end = (start + used) % bufferSize;
+    size_t first = std::min(size, bufferSize - end);
+    std::memcpy(buffer + end, data, first);
+    std::memcpy(buffer, data + first, size - first);
+    used += size;
+}
+
+size_t RingBufferSink::read(uint8_t* out, size_t max) {
+    size_t count = std::min(max, used);
+    if (count == 0) {
+        return 0;
+    }
+    size_t first = std::min(count, bufferSize - start);
+    std::memcpy(out, buffer + start, first);
+    std::memcpy(out + first, buffer, count - first);
+    start = (start + count) % bufferSize;
+    used -= count;
+    return count;
+}
+
+FileSink::FileSink(const std::string& path, size_t bufferSize)
+    : fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)), failed(false),
+      limit(bufferSize) {
+    pending.reserve(bufferSize);
+}
+
+FileSink::~FileSink() {
+    flush();
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+void FileSink::write(const uint8_t* data, size_t size) {
+    pending.insert(pending.end(), data, data + size);
+    if (pending.size() >= limit) {
+        flush();
+    }
+}
+
+void FileSink::flush() {
+    if (pending.empty() || !ok()) {
+        pending.clear();
+        return;
+    }
+    size_t done = 0;
+    while (done < pending.size()) {
+        ssize_t n = ::write(fd, pending.data() + done, pending.size() - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            failed = true;
+            break;
+        }
+        done += n;
+    }
+    pending.clear();
+}
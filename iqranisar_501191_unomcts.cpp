@@ -0,0 +1,194 @@
+#include "unomcts.h"
+#include <cmath>
+
+// Bounded random index in [0, n) with one multiply and no division
+static int randomBelow(Xoshiro256& rng, uint64_t n) {
+    return static_cast<int>(uniformBelow(rng, n));
+}
+
+void determinize(GameState& state, int viewer, Xoshiro256& rng) {
+    uint8_t pool[UNOGame::deckCapacity];
+    int poolSize = 0;
+
+    // Pool the other seats' cards, then the undrawn deck
+    for (int p = 0; p < state.numPlayers; p++) {
+        if (p == viewer) continue;
+        for (uint64_t cards = state.hands[p]; cards; cards &= cards - 1) {
+            pool[poolSize++] = static_cast<uint8_t>(Card::lowestCard(cards));
+        }
+        for (uint64_t cards = state.handDoubles[p]; cards; cards &= cards - 1) {
+            pool[poolSize++] = static_cast<uint8_t>(Card::lowestCard(cards));
+        }
+        state.hands[p] = 0;
+        state.handDoubles[p] = 0;
+    }
+    for (int i = state.drawIndex; i < UNOGame::deckCapacity; i++) {
+        pool[poolSize++] = state.deck[i];
+    }
+
+    for (int i = poolSize - 1; i > 0; i--) {
+        int j = randomBelow(rng, i + 1);
+        uint8_t temp = pool[i];
+        pool[i] = pool[j];
+        pool[j] = temp;
+    }
+
+    // Deal back with the same hand sizes; the rest becomes the deck
+    int next = 0;
+    for (int p = 0; p < state.numPlayers; p++) {
+        if (p == viewer) continue;
+        for (int k = 0; k < state.cardCounts[p]; k++) {
+            uint64_t bit = 1ull << pool[next++];
+            if (state.hands[p] & bit) {
+                state.handDoubles[p] |= bit;
+            } else {
+                state.hands[p] |= bit;
+            }
+        }
+    }
+    for (int i = state.drawIndex; i < UNOGame::deckCapacity; i++) {
+        state.deck[i] = pool[next++];
+    }
+}
+
+// Plays a fixed card; used to follow the tree during selection
+struct FixedCard {
+    int card;
+    int chooseCard(const TurnView&) { return card; }
+};
+
+MctsStrategy::MctsStrategy(const UNOGame& g, const MctsOptions& o)
+    : game(g), options(o), rng(o.seed), scratch(2), totalRollouts(0) {
+    nodes.reserve(4 * options.iterations + 1);
+}
+
+int MctsStrategy::addChild(int parent, int8_t action, int8_t player) {
+    Node child;
+    child.firstChild = -1;
+    child.nextSibling = nodes[parent].firstChild;
+    child.action = action;
+    child.player = player;
+    child.visits = 0;
+    child.availability = 0;
+    child.wins = 0;
+    nodes.push_back(child);
+    nodes[parent].firstChild = static_cast<int>(nodes.size()) - 1;
+    return nodes[parent].firstChild;
+}
+
+int MctsStrategy::findChild(int parent, int8_t action) const {
+    for (int c = nodes[parent].firstChild; c >= 0; c = nodes[c].nextSibling) {
+        if (nodes[c].action == action) {
+            return c;
+        }
+    }
+    return -1;
+}
+
+// Finish the scratch game with the default policy and return the winner.
+// Games cut off at the turn limit go to the seat with the fewest cards.
+int MctsStrategy::rollout() {
+    while (!scratch.isGameOver() && scratch.getTurnCount() < options.maxRolloutTurns) {
+        scratch.playTurn();
+    }
+    totalRollouts++;
+    if (scratch.isGameOver()) {
+        return scratch.getWinner();
+    }
+
+    GameState end = scratch.saveState();
+    int best = 0;
+    for (int p = 1; p < end.numPlayers; p++) {
+        if (end.cardCounts[p] < end.cardCounts[best]) {
+            best = p;
+        }
+    }
+    return best;
+}
+
+int MctsStrategy::chooseCard(const TurnView& view) {
+    // A single option needs no search
+    if (!(view.playable & (view.playable - 1))) {
+        return Card::lowestCard(view.playable);
+    }
+
+    const GameState root = game.saveState();
+    nodes.clear();
+    Node rootNode = {-1, -1, drawAction, -1, 0, 0, 0};
+    nodes.push_back(rootNode);
+
+    for (int iteration = 0; iteration < options.iterations; iteration++) {
+        GameState state = root;
+        determinize(state, view.player, rng);
+        scratch.loadState(state);
+
+        // Selection and expansion
+        int node = 0;
+        path.clear();
+        while (!scratch.isGameOver()) {
+            GameState current = scratch.saveState();
+            int8_t player = static_cast<int8_t>(current.currentPlayer);
+            uint64_t legal = current.hands[player] & UNOGame::playableOn(current.topCard);
+
+            // Count availability and look for an untried move
+            int untried = -1;
+            int untriedCount = 0;
+            int best = -1;
+            double bestScore = -1;
+            for (uint64_t moves = legal ? legal : 1; moves; moves &= moves - 1) {
+                int8_t action = legal ? static_cast<int8_t>(Card::lowestCard(moves)) : drawAction;
+                int child = findChild(node, action);
+                if (child < 0) {
+                    // Reservoir-sample one untried move
+                    if (randomBelow(rng, ++untriedCount) == 0) {
+                        untried = action;
+                    }
+                    continue;
+                }
+                Node& c = nodes[child];
+                c.availability++;
+                double score = c.wins / c.visits +
+                               options.exploration * std::sqrt(std::log((double)c.availability) / c.visits);
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = child;
+                }
+            }
+
+            if (untriedCount > 0) {
+                node = addChild(node, static_cast<int8_t>(untried), player);
+                nodes[node].availability = 1;
+            } else {
+                node = best;
+            }
+            path.push_back(node);
+
+            FixedCard move = {nodes[node].action};
+            scratch.playTurn(move);
+            if (untriedCount > 0) {
+                break;
+            }
+        }
+
+        // Simulation and backpropagation
+        int winner = scratch.isGameOver() ? scratch.getWinner() : rollout();
+        for (int n : path) {
+            nodes[n].visits++;
+            if (nodes[n].player == winner) {
+                nodes[n].wins += 1;
+            }
+        }
+    }
+
+    // Play the most visited legal move at the root
+    int choice = -1;
+    int mostVisits = -1;
+    for (int c = nodes[0].firstChild; c >= 0; c = nodes[c].nextSibling) {
+        if (nodes[c].action >= 0 && (view.playable & (1ull << nodes[c].action)) &&
+            nodes[c].visits > mostVisits) {
+            mostVisits = nodes[c].visits;
+            choice = nodes[c].action;
+        }
+    }
+    return choice >= 0 ? choice : Card::lowestCard(view.playable);
+}
@@ -0,0 +1,138 @@
+#include "unosim.h"
+#include "uno.h"
+#include "rng.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+
+// Games are handed out to workers in chunks of this size
+static const long long chunkSize = 256;
+
+// Turn (masterSeed, game index) into a well-mixed per-game seed
+static uint64_t gameSeed(uint64_t masterSeed, long long game) {
+    return streamSeed(masterSeed, static_cast<uint64_t>(game));
+}
+
+static SimulationResult emptyResult(int numPlayers, int maxTurns) {
+    SimulationResult result;
+    result.games = 0;
+    result.unfinished = 0;
+    result.totalTurns = 0;
+    result.wins.assign(numPlayers, 0);
+    result.bucketWidth = 10;
+    result.lengthHistogram.assign(maxTurns / result.bucketWidth + 1, 0);
+    result.skips = 0;
+    result.reverses = 0;
+    result.drawTwos = 0;
+    return result;
+}
+
+void SimulationResult::add(const SimulationResult& other) {
+    games += other.games;
+    unfinished += other.unfinished;
+    totalTurns += other.totalTurns;
+    for (size_t i = 0; i < wins.size() && i < other.wins.size(); i++) {
+        wins[i] += other.wins[i];
+    }
+    for (size_t i = 0; i < lengthHistogram.size() && i < other.lengthHistogram.size(); i++) {
+        lengthHistogram[i] += other.lengthHistogram[i];
+    }
+    skips += other.skips;
+    reverses += other.reverses;
+    drawTwos += other.drawTwos;
+}
+
+GamePool::GamePool(int size, int numPlayers) {
+    for (int i = 0; i < size; i++) {
+        games.push_back(new UNOGame(numPlayers));
+    }
+    available = games;
+}
+
+GamePool::~GamePool() {
+    for (UNOGame* game : games) {
+        delete game;
+    }
+}
+
+UNOGame* GamePool::acquire() {
+    std::lock_guard<std::mutex> guard(lock);
+    if (available.empty()) {
+        return nullptr;
+    }
+    UNOGame* game = available.back();
+    available.pop_back();
+    return game;
+}
+
+void GamePool::release(UNOGame* game) {
+    std::lock_guard<std::mutex> guard(lock);
+    available.push_back(game);
+}
+
+int GamePool::size() const {
+    return static_cast<int>(games.size());
+}
+
+// Play one game to completion on a reused game object and record it
+static void playGame(UNOGame& game, int numPlayers, uint64_t seed, int maxTurns,
+                     SimulationResult& result) {
+    game.reset(seed, numPlayers);
+
+    while (!game.isGameOver() && game.getTurnCount() < maxTurns) {
+        game.playTurn();
+    }
+
+    int turns = game.getTurnCount();
+    result.games++;
+    result.totalTurns += turns;
+    if (game.isGameOver()) {
+        result.wins[game.getWinner()]++;
+        result.lengthHistogram[turns / result.bucketWidth]++;
+    } else {
+        result.unfinished++;
+    }
+    result.skips += game.getPlayCount(Card::SKIP);
+    result.reverses += game.getPlayCount(Card::REVERSE);
+    result.drawTwos += game.getPlayCount(Card::DRAW_TWO);
+}
+
+SimulationResult simulateGames(int numPlayers, long long numGames, uint64_t masterSeed,
+                               int numThreads, int maxTurns) {
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Each worker claims chunks of game indices and keeps its totals on its
+    // own stack, storing them once at the end; adjacent entries of partial
+    // share cache lines, so updating them per game would false-share
+    std::atomic<long long> nextGame(0);
+    std::vector<SimulationResult> partial(numThreads, emptyResult(numPlayers, maxTurns));
+    std::vector<std::thread> workers;
+    GamePool pool(numThreads, numPlayers);
+
+    for (int t = 0; t < numThreads; t++) {
+        workers.emplace_back([&, t]() {
+            SimulationResult local = emptyResult(numPlayers, maxTurns);
+            UNOGame* game = pool.acquire();
+            for (;;) {
+                long long first = nextGame.fetch_add(chunkSize);
+                if (first >= numGames) break;
+                long long last = std::min(numGames, first + chunkSize);
+                for (long long i = first; i < last; i++) {
+                    playGame(*game, numPlayers, gameSeed(masterSeed, i), maxTurns, local);
+                }
+            }
+            pool.release(game);
+            partial[t] = std::move(local);
+        });
+    }
+
+    SimulationResult result = emptyResult(numPlayers, maxTurns);
+    for (int t = 0; t < numThreads; t++) {
+        workers[t].join();
+        result.add(partial[t]);
+    }
+    return result;
+}
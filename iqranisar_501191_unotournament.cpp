@@ -0,0 +1,489 @@
+#include "unotournament.h"
+#include "rng.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+typedef std::chrono::steady_clock Clock;
+
+// One table of the bracket
+struct Table {
+    int entrants[UNOGame::maxPlayers];
+    int numSeats;
+    int round;
+    int parent;                     // Next round's table, or -1 for the final
+    int parentSeat;                 // Seat the winner takes there
+    std::atomic<int> emptySeats;    // Seats still waiting for a winner
+    bool hasAsync;                  // Some seat is an AsyncSeat
+    UNOGame* game;                  // While the table is playing
+    SeatStrategies strategies;
+    std::atomic<bool> waiting;      // Parked until submitMove
+    std::atomic<int> submitted;     // Card delivered by submitMove, or -1
+    bool sampled;                   // The wait before this turn is timed
+    Clock::time_point readyAt;
+};
+
+// A pool thread: its FIFO queue of ready tables, spare games and samples
+struct Worker {
+    std::mutex lock;
+    std::deque<int> queue;
+    std::vector<UNOGame*> spareGames;
+    int sampleCountdown;
+    long long turns;
+    long long unfinished;
+    std::vector<uint32_t> turnNs;
+    std::vector<uint32_t> waitNs;
+};
+
+// Replays an AsyncSeat's card through UNOGame::playTurn
+struct SubmittedCard {
+    int card;
+
+    int chooseCard(const TurnView&) {
+        return card;
+    }
+};
+
+class TournamentData {
+public:
+    TournamentOptions options;
+    Tournament* owner;
+    std::vector<PlayerStrategy*> strategies;
+    std::vector<AsyncSeat*> asyncSeats;
+    std::unique_ptr<Table[]> tables;
+    int numTables;
+    std::vector<long long> tablesPerRound;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<long long> tablesLeft;
+    std::atomic<int> nextFirstTable;    // First-round tables not dealt yet
+    std::atomic<int> liveTables;        // Queued or playing, not parked
+    int maxLiveTables;
+    std::vector<uint8_t> roundReached;
+    int champion;
+
+    TournamentData(const TournamentOptions& opts, Tournament* tournament);
+    ~TournamentData();
+
+    void enqueue(Worker& worker, int table);
+    bool popOwn(Worker& worker, int& table);
+    bool steal(int thief, int& table);
+    void admit(Worker& worker);
+    void startTable(Worker& worker, Table& table, int index);
+    bool playTurn(Worker& worker, int index);
+    void finishTable(Worker& worker, Table& table);
+    void workerLoop(int self);
+};
+
+// Split count items into ceil(count / maxSize) groups whose sizes differ
+// by at most one. Only with maxSize 2 and an odd count is a group left
+// with a single item, which becomes a bye.
+static std::vector<int> groupSizes(int count, int maxSize) {
+    int groups = (count + maxSize - 1) / maxSize;
+    std::vector<int> sizes(groups, count / groups);
+    for (int i = 0; i < count % groups; i++) {
+        sizes[i]++;
+    }
+    return sizes;
+}
+
+TournamentData::TournamentData(const TournamentOptions& opts, Tournament* tournament)
+    : options(opts), owner(tournament), strategies(opts.entrants, nullptr),
+      asyncSeats(opts.entrants, nullptr), numTables(0), tablesLeft(0), nextFirstTable(0),
+      liveTables(0), roundReached(opts.entrants, 0), champion(-1) {
+    if (options.entrants < 2) {
+        throw std::invalid_argument("Tournament needs at least 2 entrants");
+    }
+    if (options.seatsPerTable < 2 || options.seatsPerTable > UNOGame::maxPlayers) {
+        throw std::invalid_argument("Tournament tables need 2-4 seats");
+    }
+    if (options.numThreads <= 0) {
+        options.numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    options.latencySampleEvery = std::max(options.latencySampleEvery, 1);
+    options.tablesPerWorker = std::max(options.tablesPerWorker, 1);
+    maxLiveTables = options.numThreads * options.tablesPerWorker;
+
+    // Lay out the bracket round by round: seat sizes per table
+    std::vector<std::vector<int>> rounds;
+    rounds.push_back(groupSizes(options.entrants, options.seatsPerTable));
+    while (rounds.back().size() > 1) {
+        rounds.push_back(groupSizes(static_cast<int>(rounds.back().size()), options.seatsPerTable));
+    }
+    for (const std::vector<int>& round : rounds) {
+        numTables += static_cast<int>(round.size());
+        tablesPerRound.push_back(static_cast<long long>(round.size()));
+    }
+
+    tables.reset(new Table[numTables]);
+    int first = 0;
+    int entrant = 0;
+    for (size_t r = 0; r < rounds.size(); r++) {
+        int next = first + static_cast<int>(rounds[r].size());
+        int child = r > 0 ? first - static_cast<int>(rounds[r - 1].size()) : 0;
+        for (size_t i = 0; i < rounds[r].size(); i++) {
+            Table& table = tables[first + i];
+            table.numSeats = rounds[r][i];
+            table.round = static_cast<int>(r);
+            table.parent = -1;
+            table.parentSeat = 0;
+            table.hasAsync = false;
+            table.game = nullptr;
+            table.waiting.store(false);
+            table.submitted.store(-1);
+            table.sampled = false;
+            for (int seat = 0; seat < table.numSeats; seat++) {
+                if (r == 0) {
+                    table.entrants[seat] = entrant++;
+                } else {
+                    // Winners of the previous round's tables, in order
+                    tables[child].parent = first + static_cast<int>(i);
+                    tables[child].parentSeat = seat;
+                    table.entrants[seat] = -1;
+                    child++;
+                }
+            }
+        }
+        first = next;
+    }
+
+    for (int t = 0; t < options.numThreads; t++) {
+        workers.emplace_back(new Worker);
+    }
+}
+
+TournamentData::~TournamentData() {
+    for (std::unique_ptr<Worker>& worker : workers) {
+        for (UNOGame* game : worker->spareGames) {
+            delete game;
+        }
+    }
+    for (int i = 0; i < numTables; i++) {
+        delete tables[i].game;
+    }
+}
+
+void TournamentData::enqueue(Worker& worker, int index) {
+    Table& table = tables[index];
+    table.sampled = --worker.sampleCountdown <= 0;
+    if (table.sampled) {
+        worker.sampleCountdown = options.latencySampleEvery;
+        table.readyAt = Clock::now();
+    }
+    std::lock_guard<std::mutex> guard(worker.lock);
+    worker.queue.push_back(index);
+}
+
+bool TournamentData::popOwn(Worker& worker, int& index) {
+    std::lock_guard<std::mutex> guard(worker.lock);
+    if (worker.queue.empty()) {
+        return false;
+    }
+    index = worker.queue.front();
+    worker.queue.pop_front();
+    return true;
+}
+
+// Take the newer half of another worker's queue, keeping its order
+bool TournamentData::steal(int thief, int& index) {
+    Worker& mine = *workers[thief];
+    int count = static_cast<int>(workers.size());
+    for (int k = 1; k < count; k++) {
+        Worker& victim = *workers[(thief + k) % count];
+        std::deque<int> taken;
+        {
+            std::lock_guard<std::mutex> guard(victim.lock);
+            size_t half = (victim.queue.size() + 1) / 2;
+            if (half == 0) continue;
+            taken.assign(victim.queue.end() - half, victim.queue.end());
+            victim.queue.erase(victim.queue.end() - half, victim.queue.end());
+        }
+        index = taken.front();
+        taken.pop_front();
+        if (!taken.empty()) {
+            std::lock_guard<std::mutex> guard(mine.lock);
+            mine.queue.insert(mine.queue.end(), taken.begin(), taken.end());
+        }
+        return true;
+    }
+    return false;
+}
+
+// Deal the next first-round table if fewer than maxLiveTables are in play.
+// Threads racing here may overshoot the cap by a table each.
+void TournamentData::admit(Worker& worker) {
+    if (liveTables.load(std::memory_order_relaxed) >= maxLiveTables ||
+        nextFirstTable.load(std::memory_order_relaxed) >= tablesPerRound[0]) {
+        return;
+    }
+    int index = nextFirstTable.fetch_add(1);
+    if (index < tablesPerRound[0]) {
+        liveTables.fetch_add(1);
+        enqueue(worker, index);
+    }
+}
+
+void TournamentData::startTable(Worker& worker, Table& table, int index) {
+    if (worker.spareGames.empty()) {
+        table.game = new UNOGame(table.numSeats);
+    } else {
+        table.game = worker.spareGames.back();
+        worker.spareGames.pop_back();
+    }
+    table.game->reset(streamSeed(options.seed, index), table.numSeats);
+
+    table.hasAsync = false;
+    for (int seat = 0; seat < table.numSeats; seat++) {
+        int entrant = table.entrants[seat];
+        table.strategies.setSeat(seat, strategies[entrant]);
+        table.hasAsync = table.hasAsync || asyncSeats[entrant];
+    }
+}
+
+// Play one turn of a table. Returns true if the table should be queued
+// again, false when it finished or is waiting for an AsyncSeat.
+bool TournamentData::playTurn(Worker& worker, int index) {
+    Table& table = tables[index];
+    if (table.numSeats == 1) {
+        // Bye: the lone entrant moves up without playing
+        finishTable(worker, table);
+        return false;
+    }
+    if (!table.game) {
+        startTable(worker, table, index);
+    }
+    UNOGame& game = *table.game;
+
+    AsyncSeat* async = nullptr;
+    if (table.hasAsync) {
+        async = asyncSeats[table.entrants[game.getSummary().currentPlayer]];
+    }
+    if (!async) {
+        game.playTurn(table.strategies);
+    } else {
+        SubmittedCard choice = {table.submitted.exchange(-1)};
+        if (choice.card >= 0) {
+            game.playTurn(choice);
+        } else {
+            MoveRequest request;
+            GameState state = game.saveState();
+            int seat = state.currentPlayer;
+            request.table = index;
+            request.entrant = table.entrants[seat];
+            request.view.hand = state.hands[seat];
+            request.view.handDoubles = state.handDoubles[seat];
+            request.view.playable = state.hands[seat] & UNOGame::playableOn(state.topCard);
+            request.view.topCard = state.topCard;
+            request.view.player = seat;
+            request.view.numPlayers = state.numPlayers;
+            request.view.clockwise = state.clockwise;
+            for (int i = 0; i < UNOGame::maxPlayers; i++) {
+                request.view.cardCounts[i] = state.cardCounts[i];
+            }
+            request.view.deckSize = UNOGame::deckCapacity - state.drawIndex;
+
+            if (request.view.playable) {
+                // Park the table; submitMove queues it again
+                liveTables.fetch_sub(1);
+                table.waiting.store(true);
+                async->requestMove(*owner, request);
+                return false;
+            }
+            // Nothing to choose: the seat draws
+            game.playTurn();
+        }
+    }
+
+    if (game.isGameOver() || game.getTurnCount() >= options.maxTurns) {
+        finishTable(worker, table);
+        return false;
+    }
+    return true;
+}
+
+void TournamentData::finishTable(Worker& worker, Table& table) {
+    int seat = 0;
+    if (table.game) {
+        GameSummary summary = table.game->getSummary();
+        seat = summary.winner;
+        if (seat < 0) {
+            // Turn limit: fewest cards wins, lowest seat on ties
+            worker.unfinished++;
+            seat = 0;
+            for (int i = 1; i < table.numSeats; i++) {
+                if (summary.cardCounts[i] < summary.cardCounts[seat]) {
+                    seat = i;
+                }
+            }
+        }
+        worker.turns += summary.turnCount;
+        worker.spareGames.push_back(table.game);
+        table.game = nullptr;
+    }
+
+    int winner = table.entrants[seat];
+    roundReached[winner] = static_cast<uint8_t>(table.round + 1);
+    if (table.parent < 0) {
+        champion = winner;
+    } else {
+        Table& parent = tables[table.parent];
+        parent.entrants[table.parentSeat] = winner;
+        if (parent.emptySeats.fetch_sub(1) == 1) {
+            liveTables.fetch_add(1);
+            enqueue(worker, table.parent);
+        }
+    }
+    liveTables.fetch_sub(1);
+    tablesLeft.fetch_sub(1);
+}
+
+void TournamentData::workerLoop(int self) {
+    Worker& worker = *workers[self];
+    int idle = 0;
+    while (tablesLeft.load(std::memory_order_relaxed) > 0) {
+        admit(worker);
+        int index;
+        if (!popOwn(worker, index) && !steal(self, index)) {
+            // Nothing ready: every table is running elsewhere or waiting
+            // for an AsyncSeat
+            if (++idle < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            continue;
+        }
+        idle = 0;
+
+        Table& table = tables[index];
+        bool sampled = table.sampled;
+        Clock::time_point start;
+        if (sampled) {
+            start = Clock::now();
+            worker.waitNs.push_back(static_cast<uint32_t>(std::min<long long>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(start - table.readyAt).count(),
+                UINT32_MAX)));
+        }
+        bool again = playTurn(worker, index);
+        if (sampled) {
+            worker.turnNs.push_back(static_cast<uint32_t>(std::min<long long>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count(),
+                UINT32_MAX)));
+        }
+        if (again) {
+            enqueue(worker, index);
+        }
+    }
+}
+
+// p-th percentile of samples (reorders them); 0 when empty
+static double percentile(std::vector<uint32_t>& samples, double p) {
+    if (samples.empty()) {
+        return 0;
+    }
+    size_t k = std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+Tournament::Tournament(const TournamentOptions& options)
+    : data(new TournamentData(options, this)) {}
+
+Tournament::~Tournament() {
+    delete data;
+}
+
+void Tournament::setStrategy(int entrant, PlayerStrategy* strategy) {
+    data->strategies.at(entrant) = strategy;
+}
+
+void Tournament::setAsyncSeat(int entrant, AsyncSeat* seat) {
+    data->asyncSeats.at(entrant) = seat;
+}
+
+bool Tournament::submitMove(int index, int card) {
+    if (index < 0 || index >= data->numTables) {
+        return false;
+    }
+    Table& table = data->tables[index];
+    if (!table.waiting.exchange(false)) {
+        return false;
+    }
+    // -1 means no card yet; any other invalid id falls back in playTurn
+    table.submitted.store(card < 0 ? Card::numIds : card);
+    table.sampled = false;
+    data->liveTables.fetch_add(1);
+    Worker& worker = *data->workers[index % data->workers.size()];
+    std::lock_guard<std::mutex> guard(worker.lock);
+    worker.queue.push_back(index);
+    return true;
+}
+
+TournamentResult Tournament::run() {
+    TournamentData& d = *data;
+
+    // Fresh bracket: later rounds wait for their winners
+    for (int i = 0; i < d.numTables; i++) {
+        Table& table = d.tables[i];
+        table.emptySeats.store(table.round == 0 ? 0 : table.numSeats);
+        table.waiting.store(false);
+        table.submitted.store(-1);
+        table.sampled = false;
+    }
+    std::fill(d.roundReached.begin(), d.roundReached.end(), 0);
+    d.champion = -1;
+    d.tablesLeft.store(d.numTables);
+    d.nextFirstTable.store(0);
+    d.liveTables.store(0);
+    for (std::unique_ptr<Worker>& worker : d.workers) {
+        worker->queue.clear();
+        worker->sampleCountdown = d.options.latencySampleEvery;
+        worker->turns = 0;
+        worker->unfinished = 0;
+        worker->turnNs.clear();
+        worker->waitNs.clear();
+    }
+
+    // Workers deal the first-round tables themselves, a few at a time
+    int numWorkers = static_cast<int>(d.workers.size());
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numWorkers; t++) {
+        threads.emplace_back(&TournamentData::workerLoop, &d, t);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    TournamentResult result;
+    result.champion = d.champion;
+    result.rounds = static_cast<int>(d.tablesPerRound.size());
+    result.tables = d.numTables;
+    result.unfinishedTables = 0;
+    result.turns = 0;
+    std::vector<uint32_t> turnNs, waitNs;
+    for (std::unique_ptr<Worker>& worker : d.workers) {
+        result.unfinishedTables += worker->unfinished;
+        result.turns += worker->turns;
+        turnNs.insert(turnNs.end(), worker->turnNs.begin(), worker->turnNs.end());
+        waitNs.insert(waitNs.end(), worker->waitNs.begin(), worker->waitNs.end());
+    }
+    result.seconds = seconds;
+    result.turnsPerSecond = seconds > 0 ? result.turns / seconds : 0;
+    result.turnP50 = percentile(turnNs, 0.5);
+    result.turnP99 = percentile(turnNs, 0.99);
+    result.turnP999 = percentile(turnNs, 0.999);
+    result.turnMax = percentile(turnNs, 1.0);
+    result.waitP50 = percentile(waitNs, 0.5);
+    result.waitP99 = percentile(waitNs, 0.99);
+    result.waitP999 = percentile(waitNs, 0.999);
+    result.waitMax = percentile(waitNs, 1.0);
+    result.tablesPerRound = d.tablesPerRound;
+    result.roundReached = d.roundReached;
+    return result;
+}
@@ -1,10 +1,18 @@
 #ifndef POLYNOMIAL_H
 #define POLYNOMIAL_H
 
+#include <cstdint>
 #include <string>
 
 class Polynomial {
 public:
+    Polynomial();
+
+    // Copies are deep: every polynomial owns its own terms
+    Polynomial(const Polynomial& other);
+    Polynomial& operator=(const Polynomial& other);
+    virtual ~Polynomial();
+
     // Insert a term into the polynomial
     virtual void insertTerm(int coefficient, int exponent);
     
@@ -19,6 +27,10 @@ public:
 
     // Return a new polynomial that is the derivative of this polynomial
     virtual Polynomial derivative() const;
+
+private:
+    // Handle of the terms in the polynomial registry (registry.h)
+    uint64_t handle;
 };
 
 #endif
\ No newline at end of file
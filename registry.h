@@ -0,0 +1,433 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+// Thread-safe object registry shared by Polynomial and TextEditor. Each
+// object keeps only a 64-bit handle, the slot index plus the slot's
+// generation, so a stale handle never finds the slot's next occupant. Lookups are wait-free, slots come from sharded lock-free free
+// lists, and removed objects are freed by epoch-based reclamation once no
+// thread that might still be reading them holds a ReadGuard.
+
+typedef uint64_t ObjectHandle;   // 0 is never a valid handle
+
+// Epoch-based reclamation. A thread pins the current epoch while it reads
+// shared objects; a removed object is retired with the epoch it was
+// removed in and freed once the epoch has advanced twice, which can only
+// happen after every thread pinned at that time has unpinned.
+//
+// A thread's state is a thread_local, destroyed before objects with static
+// storage. Pins and retires after that, from static destructors, hold the
+// epoch back through a shared counter and retire through the orphan list,
+// which frees them at once unless another thread is pinned.
+class EpochDomain {
+public:
+    static const int maxThreads = 256;
+    static const int scanEvery = 64;    // Retires between reclamation passes
+
+    static EpochDomain& instance() {
+        // Never destroyed: threads may still retire objects during exit
+        static EpochDomain* domain = new EpochDomain();
+        return *domain;
+    }
+
+    // Pins nest; only the outermost pin publishes the epoch
+    void pin() {
+        if (threadStatus() == EXITED) {
+            lateReaders.fetch_add(1);
+            return;
+        }
+        ThreadState& state = local();
+        if (state.pinDepth++ > 0) {
+            return;
+        }
+        std::atomic<uint64_t>& mine = records[state.record].epoch;
+        uint64_t epoch = globalEpoch.load();
+        while (true) {
+            mine.store(epoch);
+            uint64_t now = globalEpoch.load();
+            if (now == epoch) break;
+            epoch = now;
+        }
+    }
+
+    void unpin() {
+        if (threadStatus() == EXITED) {
+            lateReaders.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+        ThreadState& state = local();
+        if (--state.pinDepth == 0) {
+            records[state.record].epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    // Free object with destroy once no reader can still see it. object
+    // must already be unreachable; destroy must not retire anything.
+    void retire(void* object, void (*destroy)(void*)) {
+        Retired entry = {object, destroy, globalEpoch.load()};
+        if (threadStatus() == EXITED) {
+            std::lock_guard<std::mutex> guard(orphanLock);
+            orphans.push_back(entry);
+            for (int i = 0; i < 3; i++) {
+                tryAdvance();
+            }
+            reclaim(orphans);
+            hasOrphans.store(!orphans.empty(), std::memory_order_relaxed);
+            return;
+        }
+        ThreadState& state = local();
+        state.retired.push_back(entry);
+        if (++state.sinceScan < scanEvery) {
+            return;
+        }
+        state.sinceScan = 0;
+        tryAdvance();
+        reclaim(state.retired);
+        if (hasOrphans.load(std::memory_order_relaxed) && orphanLock.try_lock()) {
+            reclaim(orphans);
+            hasOrphans.store(!orphans.empty(), std::memory_order_relaxed);
+            orphanLock.unlock();
+        }
+    }
+
+    // Advance as far as possible and free everything nobody is reading;
+    // with no thread pinned this frees every retired object
+    void collect() {
+        for (int i = 0; i < 3; i++) {
+            tryAdvance();
+        }
+        if (threadStatus() != EXITED) {
+            reclaim(local().retired);
+        }
+        std::lock_guard<std::mutex> guard(orphanLock);
+        reclaim(orphans);
+        hasOrphans.store(!orphans.empty(), std::memory_order_relaxed);
+    }
+
+    // Small per-thread index, stable for the thread's lifetime (0 once its
+    // state is gone)
+    int threadIndex() {
+        return threadStatus() == EXITED ? 0 : local().record;
+    }
+
+private:
+    struct Record {
+        std::atomic<uint64_t> epoch;    // Pinned epoch, or 0
+        std::atomic<bool> used;
+        char padding[64 - sizeof(std::atomic<uint64_t>) - sizeof(std::atomic<bool>)];
+    };
+
+    struct Retired {
+        void* object;
+        void (*destroy)(void*);
+        uint64_t epoch;
+    };
+
+    struct ThreadState {
+        int record;
+        int pinDepth;
+        int sinceScan;
+        std::vector<Retired> retired;
+
+        ThreadState() : record(instance().claimRecord()), pinDepth(0), sinceScan(0) {}
+
+        ~ThreadState() {
+            instance().threadExit(*this);
+            threadStatus() = EXITED;
+        }
+    };
+
+    enum ThreadStatus { RUNNING, EXITED };
+
+    Record records[maxThreads];
+    std::atomic<int> recordsUsed;       // Highest claimed record + 1
+    std::atomic<uint64_t> globalEpoch;
+    std::mutex orphanLock;              // Leftovers of exited threads
+    std::vector<Retired> orphans;
+    std::atomic<bool> hasOrphans;
+    std::atomic<int> lateReaders;       // Pins by threads whose state is gone
+
+    EpochDomain() : recordsUsed(0), globalEpoch(1), hasOrphans(false), lateReaders(0) {
+        for (int i = 0; i < maxThreads; i++) {
+            records[i].epoch.store(0, std::memory_order_relaxed);
+            records[i].used.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    static ThreadState& local() {
+        static thread_local ThreadState state;
+        return state;
+    }
+
+    // Trivially destructible, so it can still be read once state is gone
+    static int& threadStatus() {
+        static thread_local int status = RUNNING;
+        return status;
+    }
+
+    int claimRecord() {
+        for (int i = 0; i < maxThreads; i++) {
+            bool expected = false;
+            if (!records[i].used.load(std::memory_order_relaxed) &&
+                records[i].used.compare_exchange_strong(expected, true)) {
+                int used = recordsUsed.load();
+                while (used < i + 1 && !recordsUsed.compare_exchange_weak(used, i + 1)) {
+                }
+                return i;
+            }
+        }
+        throw std::runtime_error("EpochDomain: too many threads");
+    }
+
+    void threadExit(ThreadState& state) {
+        records[state.record].epoch.store(0);
+        tryAdvance();
+        reclaim(state.retired);
+        if (!state.retired.empty()) {
+            std::lock_guard<std::mutex> guard(orphanLock);
+            orphans.insert(orphans.end(), state.retired.begin(), state.retired.end());
+            hasOrphans.store(true, std::memory_order_relaxed);
+        }
+        records[state.record].used.store(false, std::memory_order_release);
+    }
+
+    // Move to the next epoch if every pinned thread has seen this one
+    void tryAdvance() {
+        if (lateReaders.load() != 0) {
+            return;
+        }
+        uint64_t epoch = globalEpoch.load();
+        int used = recordsUsed.load();
+        for (int i = 0; i < used; i++) {
+            uint64_t pinned = records[i].epoch.load();
+            if (pinned != 0 && pinned != epoch) return;
+        }
+        globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+    }
+
+    void reclaim(std::vector<Retired>& list) {
+        uint64_t epoch = globalEpoch.load();
+        size_t kept = 0;
+        for (size_t i = 0; i < list.size(); i++) {
+            if (list[i].epoch + 2 <= epoch) {
+                list[i].destroy(list[i].object);
+            } else {
+                list[kept++] = list[i];
+            }
+        }
+        list.resize(kept);
+    }
+};
+
+// Keeps objects found through ObjectRegistry::find alive while in scope,
+// even if another thread removes them meanwhile
+class ReadGuard {
+public:
+    ReadGuard() {
+        EpochDomain::instance().pin();
+    }
+
+    ~ReadGuard() {
+        EpochDomain::instance().unpin();
+    }
+
+    ReadGuard(const ReadGuard&) = delete;
+    ReadGuard& operator=(const ReadGuard&) = delete;
+};
+
+// Owns heap objects of type T and hands out handles to them. Slots live in
+// chunks that are allocated on demand and never move, so a lookup is an
+// index into a chunk plus a generation check. Owners that never race with
+// remove() on their own handle can call find() without a ReadGuard.
+template <class T>
+class ObjectRegistry {
+public:
+    static const int chunkBits = 12;
+    static const uint32_t chunkSize = 1u << chunkBits;
+    static const uint32_t maxChunks = 1u << 14;     // 67M live objects
+    static const int shards = 16;
+
+    ObjectRegistry() : nextIndex(0) {
+        for (uint32_t i = 0; i < maxChunks; i++) {
+            chunks[i].store(nullptr, std::memory_order_relaxed);
+        }
+        for (int i = 0; i < shards; i++) {
+            freeLists[i].head.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Deletes objects still registered; no other thread may use it then
+    ~ObjectRegistry() {
+        for (uint32_t c = 0; c < maxChunks; c++) {
+            Slot* chunk = chunks[c].load();
+            if (!chunk) continue;
+            for (uint32_t i = 0; i < chunkSize; i++) {
+                delete chunk[i].object.load();
+            }
+            delete[] chunk;
+        }
+    }
+
+    ObjectRegistry(const ObjectRegistry&) = delete;
+    ObjectRegistry& operator=(const ObjectRegistry&) = delete;
+
+    // Take ownership of object and return its handle
+    ObjectHandle insert(T* object) {
+        uint32_t index;
+        if (!popFree(index)) {
+            index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+            if (index >= maxChunks * chunkSize) {
+                throw std::length_error("ObjectRegistry is full");
+            }
+            ensureChunk(index >> chunkBits);
+        }
+        Slot& slot = slotAt(index);
+        uint32_t generation = slot.generation.load(std::memory_order_relaxed);
+        if (generation == 0) {
+            generation = 1;
+            slot.generation.store(generation, std::memory_order_relaxed);
+        }
+        slot.object.store(object, std::memory_order_release);
+        return (static_cast<uint64_t>(generation) << 32) | index;
+    }
+
+    // The object behind handle, or nullptr once it has been removed
+    T* find(ObjectHandle handle) const {
+        uint32_t index = static_cast<uint32_t>(handle);
+        uint32_t generation = static_cast<uint32_t>(handle >> 32);
+        // A stale or forged handle may name a slot past the chunk table
+        if (generation == 0 || (index >> chunkBits) >= maxChunks) {
+            return nullptr;
+        }
+        const Slot* chunk = chunks[index >> chunkBits].load(std::memory_order_acquire);
+        if (!chunk) {
+            return nullptr;
+        }
+        const Slot& slot = chunk[index & (chunkSize - 1)];
+        if (slot.generation.load(std::memory_order_acquire) != generation) {
+            return nullptr;
+        }
+        T* object = slot.object.load(std::memory_order_acquire);
+        // The slot may have been freed and reused between the two loads
+        if (slot.generation.load(std::memory_order_acquire) != generation) {
+            return nullptr;
+        }
+        return object;
+    }
+
+    // Unregister handle and retire its object; false if already removed
+    bool remove(ObjectHandle handle) {
+        uint32_t index = static_cast<uint32_t>(handle);
+        uint32_t generation = static_cast<uint32_t>(handle >> 32);
+        if (generation == 0 || (index >> chunkBits) >= maxChunks) {
+            return false;
+        }
+        Slot* chunk = chunks[index >> chunkBits].load(std::memory_order_acquire);
+        if (!chunk) {
+            return false;
+        }
+        Slot& slot = chunk[index & (chunkSize - 1)];
+        uint32_t next = generation + 1 == 0 ? 1 : generation + 1;
+        if (!slot.generation.compare_exchange_strong(generation, next)) {
+            return false;
+        }
+        T* object = slot.object.exchange(nullptr);
+        pushFree(index);
+        EpochDomain::instance().retire(object, &destroy);
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<T*> object;
+        std::atomic<uint32_t> generation;
+        std::atomic<uint32_t> nextFree;     // Free list link: index + 1, or 0
+    };
+
+    // Treiber stack head: a tag against ABA in the high half, index + 1 of
+    // the top slot in the low half
+    struct FreeList {
+        std::atomic<uint64_t> head;
+        char padding[64 - sizeof(std::atomic<uint64_t>)];
+    };
+
+    std::atomic<Slot*> chunks[maxChunks];
+    FreeList freeLists[shards];
+    std::atomic<uint32_t> nextIndex;
+
+    static void destroy(void* object) {
+        delete static_cast<T*>(object);
+    }
+
+    Slot& slotAt(uint32_t index) {
+        return chunks[index >> chunkBits].load(std::memory_order_acquire)[index & (chunkSize - 1)];
+    }
+
+    void ensureChunk(uint32_t c) {
+        if (chunks[c].load(std::memory_order_acquire)) {
+            return;
+        }
+        Slot* fresh = new Slot[chunkSize];
+        for (uint32_t i = 0; i < chunkSize; i++) {
+            fresh[i].object.store(nullptr, std::memory_order_relaxed);
+            fresh[i].generation.store(0, std::memory_order_relaxed);
+            fresh[i].nextFree.store(0, std::memory_order_relaxed);
+        }
+        Slot* expected = nullptr;
+        if (!chunks[c].compare_exchange_strong(expected, fresh)) {
+            delete[] fresh;
+        }
+    }
+
+    // Each thread frees into its own shard and allocates from it first
+    int homeShard() {
+        return EpochDomain::instance().threadIndex() % shards;
+    }
+
+    void pushFree(uint32_t index) {
+        std::atomic<uint64_t>& head = freeLists[homeShard()].head;
+        Slot& slot = slotAt(index);
+        uint64_t top = head.load(std::memory_order_relaxed);
+        uint64_t next;
+        do {
+            slot.nextFree.store(static_cast<uint32_t>(top), std::memory_order_relaxed);
+            next = (((top >> 32) + 1) << 32) | (index + 1);
+        } while (!head.compare_exchange_weak(top, next, std::memory_order_release,
+                                             std::memory_order_relaxed));
+    }
+
+    bool popFree(uint32_t& index) {
+        int home = homeShard();
+        for (int k = 0; k < shards; k++) {
+            std::atomic<uint64_t>& head = freeLists[(home + k) % shards].head;
+            uint64_t top = head.load(std::memory_order_acquire);
+            while (static_cast<uint32_t>(top) != 0) {
+                uint32_t candidate = static_cast<uint32_t>(top) - 1;
+                uint32_t link = slotAt(candidate).nextFree.load(std::memory_order_relaxed);
+                uint64_t next = (((top >> 32) + 1) << 32) | link;
+                if (head.compare_exchange_weak(top, next, std::memory_order_acquire,
+                                               std::memory_order_acquire)) {
+                    index = candidate;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+};
+
+// The process-wide registry of T, which the module owning T looks its
+// objects up in. Never destroyed, so objects with static storage can
+// outlive it.
+template <class T>
+ObjectRegistry<T>& registryFor() {
+    static ObjectRegistry<T>* registry = new ObjectRegistry<T>();
+    return *registry;
+}
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+// Small, fast random number generators. Each one satisfies the standard
+// UniformRandomBitGenerator requirements, so it can drive std::shuffle,
+// the <random> distributions or UNOGame::initializeWith.
+
+// SplitMix64: one 64-bit word of state; mainly used to expand a seed
+class SplitMix64 {
+public:
+    typedef uint64_t result_type;
+
+    explicit SplitMix64(uint64_t seed) : state(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t state;
+};
+
+// xoshiro256** (Blackman & Vigna), seeded through SplitMix64
+class Xoshiro256 {
+public:
+    typedef uint64_t result_type;
+
+    explicit Xoshiro256(uint64_t seed) {
+        SplitMix64 seeder(seed);
+        for (int i = 0; i < 4; i++) {
+            s[i] = seeder();
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+// PCG32 (XSH-RR variant, O'Neill): 64-bit state, 32-bit output
+class Pcg32 {
+public:
+    typedef uint32_t result_type;
+
+    explicit Pcg32(uint64_t seed, uint64_t stream = 0x14057B7EF767814Full)
+        : state(0), increment((stream << 1) | 1) {
+        (*this)();
+        state += seed;
+        (*this)();
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    result_type operator()() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ull + increment;
+        uint32_t xorShifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xorShifted >> rot) | (xorShifted << ((32 - rot) & 31));
+    }
+
+private:
+    uint64_t state;
+    uint64_t increment;
+};
+
+// Integer in [0, n) from one draw of a 64-bit generator, by taking the
+// high half of draw * n: no division, and a bias below n / 2^64
+template <class Rng>
+inline uint64_t uniformBelow(Rng& rng, uint64_t n) {
+    static_assert(Rng::max() == UINT64_MAX && Rng::min() == 0, "uniformBelow needs 64-bit draws");
+    uint64_t x = rng();
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 Wide;
+    return static_cast<uint64_t>((static_cast<Wide>(x) * n) >> 64);
+#else
+    // High 64 bits of the product from 32-bit halves
+    uint64_t xLow = x & 0xFFFFFFFFull, xHigh = x >> 32;
+    uint64_t nLow = n & 0xFFFFFFFFull, nHigh = n >> 32;
+    uint64_t lowLow = xLow * nLow, lowHigh = xLow * nHigh;
+    uint64_t highLow = xHigh * nLow, highHigh = xHigh * nHigh;
+    uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFull) + (highLow & 0xFFFFFFFFull);
+    return highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+#endif
+}
+
+// Seed for stream index of a run seeded with masterSeed. The master seed
+// is mixed before the index is combined with it, so runs whose master
+// seeds differ by k do not replay the same streams shifted by k.
+inline uint64_t streamSeed(uint64_t masterSeed, uint64_t index) {
+    return SplitMix64(SplitMix64(masterSeed)() ^ index)();
+}
+
+#endif
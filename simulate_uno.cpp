@@ -0,0 +1,54 @@
+#include "unosim.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sys/resource.h>
+
+// Bulk UNO simulation.
+//
+// Usage:
+//   simulate_uno [players] [games] [seed] [threads]
+// Defaults: 4 players, 1000000 games, seed 1234, all cores.
+
+int main(int argc, char** argv) {
+    int numPlayers = argc > 1 ? std::atoi(argv[1]) : 4;
+    long long numGames = argc > 2 ? std::atoll(argv[2]) : 1000000;
+    uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1234;
+    int numThreads = argc > 4 ? std::atoi(argv[4]) : 0;
+
+    if (numPlayers < 2 || numPlayers > 4 || numGames <= 0) {
+        std::cerr << "usage: " << argv[0] << " [players 2-4] [games] [seed] [threads]" << std::endl;
+        return 1;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    SimulationResult r = simulateGames(numPlayers, numGames, seed, numThreads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("games:        %lld (%lld unfinished)\n", r.games, r.unfinished);
+    std::printf("elapsed:      %.3f s\n", seconds);
+    std::printf("throughput:   %.0f games/s, %.0f turns/s\n", r.games / seconds, r.totalTurns / seconds);
+    std::printf("avg length:   %.1f turns\n", (double)r.totalTurns / r.games);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::printf("peak RSS:     %ld KB\n", usage.ru_maxrss);
+
+    std::printf("win rate:    ");
+    for (size_t i = 0; i < r.wins.size(); i++) {
+        std::printf(" P%zu %.2f%%", i, 100.0 * r.wins[i] / r.games);
+    }
+    std::printf("\n");
+
+    std::printf("action cards per game: skip %.2f, reverse %.2f, draw two %.2f\n",
+                (double)r.skips / r.games, (double)r.reverses / r.games, (double)r.drawTwos / r.games);
+
+    std::printf("game length histogram:\n");
+    for (size_t i = 0; i < r.lengthHistogram.size(); i++) {
+        if (r.lengthHistogram[i] == 0) continue;
+        std::printf("  %4zu-%-4zu %lld\n", i * r.bucketWidth, (i + 1) * r.bucketWidth - 1,
+                    r.lengthHistogram[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "registry.h"
+#include "polynomial.h"
+#include "texteditor.h"
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <unistd.h>
+
+// Checks that out-of-range handles are rejected, and that objects with
+// static storage can outlive the registry's per-thread state. Thread-local
+// state is destroyed before static objects, so the statics below are
+// removed, and their data retired, after this thread's EpochDomain state
+// is gone. Build with -fsanitize=address to also catch use of that state
+// after it is destroyed.
+//
+// Usage:
+//   test_registry          exits non-zero if a check fails
+
+// Counts live instances, so the exit check can see the retired one freed
+struct Tracked {
+    static std::atomic<int> live;
+
+    Tracked() {
+        live++;
+    }
+
+    ~Tracked() {
+        live--;
+    }
+};
+
+std::atomic<int> Tracked::live(0);
+
+// Registers a Tracked for as long as it exists
+struct TrackedOwner {
+    ObjectHandle handle;
+
+    TrackedOwner() : handle(registryFor<Tracked>().insert(new Tracked())) {}
+
+    ~TrackedOwner() {
+        registryFor<Tracked>().remove(handle);
+    }
+};
+
+static int check(bool ok, const char* name) {
+    std::printf("%s: %s\n", ok ? "ok  " : "FAIL", name);
+    std::fflush(stdout);
+    return ok ? 0 : 1;
+}
+
+// Constructed first, so destroyed after every static below
+struct ExitCheck {
+    ~ExitCheck() {
+        // Reads under a ReadGuard must still work this late
+        {
+            ReadGuard guard;
+        }
+        int failures = check(Tracked::live.load() == 0, "objects removed during static destruction are freed");
+        _exit(failures ? 1 : 0);
+    }
+};
+
+static ExitCheck exitCheck;
+static Polynomial staticPoly;
+static TextEditor staticEditor;
+static TrackedOwner staticTracked;
+
+int main() {
+    int failures = 0;
+
+    staticPoly.insertTerm(3, 2);
+    staticPoly.insertTerm(1, 0);
+    failures += check(staticPoly.derivative().toString() == "6x",
+                      "static polynomial is usable");
+
+    staticEditor.insertChar('a');
+    staticEditor.insertChar('b');
+    failures += check(staticEditor.getTextWithCursor() == "ab|", "static editor is usable");
+
+    // Another thread retires objects and exits while the statics live on
+    std::thread worker([]() {
+        for (int i = 0; i < 1000; i++) {
+            TrackedOwner owner;
+        }
+    });
+    worker.join();
+    EpochDomain::instance().collect();
+    failures += check(Tracked::live.load() == 1, "objects retired by an exited thread are freed");
+
+    // Handles naming slots past the chunk table are simply not found
+    ObjectHandle forged = (static_cast<uint64_t>(1) << 32) | 0xFFFFFFFFu;
+    failures += check(!registryFor<Tracked>().find(forged) && !registryFor<Tracked>().remove(forged),
+                      "out-of-range handles are not found");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,51 @@
+#include "unosim.h"
+#include <cstdio>
+#include <vector>
+
+// Checks of simulateGames' seeding:
+//   - adjacent master seeds must give different aggregate results
+//   - the thread count must not change the results
+//
+// Usage:
+//   test_unosim            exits non-zero if a check fails
+
+static bool sameResult(const SimulationResult& a, const SimulationResult& b) {
+    return a.games == b.games && a.unfinished == b.unfinished && a.totalTurns == b.totalTurns &&
+           a.wins == b.wins && a.lengthHistogram == b.lengthHistogram && a.skips == b.skips &&
+           a.reverses == b.reverses && a.drawTwos == b.drawTwos;
+}
+
+// Sum of absolute differences; seeds that only shift the game streams by
+// one change at most two games, so at most 2 here
+static long long distance(const std::vector<long long>& a, const std::vector<long long>& b) {
+    long long total = 0;
+    for (size_t i = 0; i < a.size() && i < b.size(); i++) {
+        total += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+    }
+    return total;
+}
+
+static int check(bool ok, const char* name) {
+    std::printf("%s: %s\n", ok ? "ok  " : "FAIL", name);
+    return ok ? 0 : 1;
+}
+
+int main() {
+    const long long numGames = 20000;
+    int failures = 0;
+
+    SimulationResult a = simulateGames(4, numGames, 1234, 1);
+    SimulationResult b = simulateGames(4, numGames, 1235, 1);
+    failures += check(distance(a.wins, b.wins) > 2 && distance(a.lengthHistogram, b.lengthHistogram) > 2,
+                      "master seeds 1234 and 1235 play different games");
+
+    SimulationResult c = simulateGames(4, numGames, 0, 1);
+    SimulationResult d = simulateGames(4, numGames, 1, 1);
+    failures += check(distance(c.wins, d.wins) > 2 && distance(c.lengthHistogram, d.lengthHistogram) > 2,
+                      "master seeds 0 and 1 play different games");
+
+    SimulationResult threaded = simulateGames(4, numGames, 1234, 3);
+    failures += check(sameResult(a, threaded), "1 and 3 threads give identical results");
+
+    return failures ? 1 : 0;
+}
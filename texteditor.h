@@ -1,11 +1,31 @@
 #ifndef TEXTEDITOR_H
 #define TEXTEDITOR_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
+// Group commit settings for TextEditor::openJournal. Buffered edits are
+// written and fsynced by the first edit that finds either threshold
+// reached. There is no timer: if edits stop, pending ones are only synced
+// by pollJournal, syncJournal or closeJournal, so an owner that needs the
+// interval to hold while idle must call pollJournal periodically.
+struct JournalOptions {
+    size_t syncBytes = 64 * 1024;     // Bytes of pending records
+    int syncIntervalMs = 100;         // Age of the oldest pending record
+    size_t checkpointOps = 1 << 20;   // Operations between compactions
+};
 
 class TextEditor {
 public:
+    TextEditor();
+
+    // Closes the journal, if any
+    virtual ~TextEditor();
+
+    TextEditor(const TextEditor&) = delete;
+    TextEditor& operator=(const TextEditor&) = delete;
+
     // Insert character at cursor
     virtual void insertChar(char c);
 
@@ -20,6 +40,68 @@ public:
 
     // Return string with cursor position
     virtual std::string getTextWithCursor() const;
+
+    // Recover from <path>.ckpt plus the edit journal at path, then append
+    // every later edit to the journal. If neither file exists the current
+    // text becomes the first checkpoint. Returns false on I/O failure.
+    virtual bool openJournal(const std::string& path,
+                             const JournalOptions& options = JournalOptions());
+
+    // Write and fsync any pending journal records now
+    virtual bool syncJournal();
+
+    // Sync pending records if the oldest is older than syncIntervalMs.
+    // Cheap when there is nothing to do; call it from an idle loop or timer.
+    virtual bool pollJournal();
+
+    // True once a journal write, fsync or checkpoint has failed. Edits are
+    // then refused, so the text never runs ahead of what recovery would
+    // rebuild, until openJournal recovers from the files on disk.
+    virtual bool journalFailed() const;
+
+    // Checkpoint the text and truncate the journal
+    virtual bool compactJournal();
+
+    // Sync and detach the journal
+    virtual void closeJournal();
+
+private:
+    // Handle of the editor's data in the editor registry (registry.h)
+    uint64_t handle;
+
+    friend class DocumentManager;
+};
+
+// Hosts many open documents, one TextEditor each, under a shared memory
+// budget. When resident text exceeds the budget the least recently used
+// documents are written to spillDir and freed; the next call on their
+// TextEditor reloads them transparently.
+class DocumentManager {
+public:
+    DocumentManager(size_t memoryBudget, const std::string& spillDir);
+    ~DocumentManager();
+
+    DocumentManager(const DocumentManager&) = delete;
+    DocumentManager& operator=(const DocumentManager&) = delete;
+
+    // Return the editor for a document, creating an empty one on first use
+    TextEditor& open(size_t docId);
+
+    // Discard a document, including any spilled copy on disk
+    void close(size_t docId);
+
+    // Bytes of text storage held by resident documents
+    size_t memoryUsage() const;
+
+    // Bytes of text storage held by one document (0 while evicted)
+    size_t documentMemory(size_t docId) const;
+
+    // Number of open documents currently in memory / spilled to disk
+    size_t residentCount() const;
+    size_t evictedCount() const;
+
+private:
+    class ManagerData* data;
 };
 
 #endif
\ No newline at end of file
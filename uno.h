@@ -1,6 +1,8 @@
 #ifndef UNO_H
 #define UNO_H
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -16,19 +18,161 @@ struct Card {
     
     std::string getColorString() const;
     std::string getValueString() const;
+    
+    // Compact 1-byte card id: color * 13 + face, where faces 0-9 are number
+    // cards followed by Skip, Reverse and Draw Two. All ids fit in a 64-bit mask.
+    static const int facesPerColor = 13;
+    static const int numIds = 4 * facesPerColor;
+
+    // Masks of card ids by color and by kind
+    static constexpr uint64_t colorCards = (1ull << facesPerColor) - 1;
+    static constexpr uint64_t skipCards = (1ull << 10) * (1ull | 1ull << 13 | 1ull << 26 | 1ull << 39);
+    static constexpr uint64_t reverseCards = skipCards << 1;
+    static constexpr uint64_t drawTwoCards = skipCards << 2;
+    static constexpr uint64_t actionCards = skipCards | reverseCards | drawTwoCards;
+
+    static uint64_t cardsOfColor(int color) {
+        return colorCards << (color * facesPerColor);
+    }
+
+    static int lowestCard(uint64_t cards) {
+        return __builtin_ctzll(cards);
+    }
+    
+    uint8_t id() const {
+        int face = type == NUMBER ? value : 9 + type;
+        return static_cast<uint8_t>(color * facesPerColor + face);
+    }
+    
+    static Card fromId(uint8_t id) {
+        Color c = static_cast<Color>(id / facesPerColor);
+        int face = id % facesPerColor;
+        if (face <= 9) {
+            return Card(c, NUMBER, face);
+        }
+        return Card(c, static_cast<Type>(face - 9), -1);
+    }
+};
+
+// What a strategy sees when it has to choose a card. Hands are masks of
+// card ids (bit i set for Card::fromId(i)).
+struct TurnView {
+    uint64_t hand;          // Cards held at least once
+    uint64_t handDoubles;   // Cards held twice
+    uint64_t playable;      // Cards in hand that may be played now; never 0
+    uint8_t topCard;
+    int player;             // Seat choosing the card
+    int numPlayers;
+    bool clockwise;
+    int cardCounts[4];      // Hand size of every seat
+    int deckSize;
+};
+
+// A complete game position as plain data, about 180 bytes. It is
+// trivially copyable, so searches can clone positions with memcpy.
+struct GameState {
+    uint64_t hands[4];          // Card ids held at least once, per seat
+    uint64_t handDoubles[4];    // Card ids held twice, per seat
+    uint8_t cardCounts[4];
+    uint8_t deck[100];          // Draw pile; cards before drawIndex are gone
+    uint8_t drawIndex;
+    uint8_t topCard;
+    uint8_t numPlayers;
+    uint8_t currentPlayer;
+    bool clockwise;
 };
 
+// What getState() describes, as plain data: no strings, no allocation
+struct GameSummary {
+    uint8_t cardCounts[4];      // Hand size per seat; 0 for unused seats
+    uint8_t topCard;            // Card id (Card::fromId)
+    uint8_t numPlayers;
+    uint8_t currentPlayer;
+    bool clockwise;
+    uint8_t deckSize;           // Cards left to draw
+    int8_t winner;              // Seat with an empty hand, or -1
+    int turnCount;
+};
+
+// Lifetime counters of one UNOGame, summed over every game it has dealt.
+// Only the thread playing the game writes them, and each counter can be
+// read from any other thread while it plays (see UNOGame::getCounters).
+struct GameCounters {
+    // Turn latency buckets: bucket b counts turns that took [2^b, 2^(b+1))
+    // ns; the last bucket also holds everything slower
+    static const int latencyBuckets = 32;
+
+    uint64_t gamesDealt;
+    uint64_t gamesWon;
+    uint64_t turnsPlayed;
+    uint64_t cardsDrawn;        // After the deal: draw turns and Draw Two
+    uint64_t deckExhausted;     // Cards that could not be drawn, deck empty
+    uint64_t timedTurns;        // Turns sampled by setTurnTiming
+    uint64_t turnLatency[latencyBuckets];
+};
+
+class GameData;
+class EventSink;
+
 class UNOGame {
 public:
-    // Initialize game with given number of players
+    // Largest supported table
+    static const int maxPlayers = 4;
+
+    // Initialize game with given number of players (2 to maxPlayers)
     UNOGame(int numPlayers);
 
-    // Shuffle and deal cards to players
+    // Release the game's cards and player data
+    virtual ~UNOGame();
+
+    UNOGame(const UNOGame&) = delete;
+    UNOGame& operator=(const UNOGame&) = delete;
+
+    // Number of cards in a full deck: per color one 0, two of each 1-9 and
+    // two each of Skip, Reverse and Draw Two
+    static const int deckCapacity = 100;
+
+    // Shuffle with std::mt19937 seeded 1234 and deal cards to players
     virtual void initialize();
 
+    // Shuffle with a Xoshiro256 generator seeded with seed and deal
+    virtual void initialize(uint64_t seed);
+
+    // Start a new game in place with a new seed and seat count. Reuses the
+    // existing game data, so it never allocates.
+    virtual void reset(uint64_t seed, int numPlayers);
+
+    // Shuffle with any UniformRandomBitGenerator (see rng.h) and deal.
+    // Uses std::shuffle, so standard engines give their usual permutation.
+    template <class Rng>
+    void initializeWith(Rng& rng) {
+        uint8_t* cards = resetDeck();
+        std::shuffle(cards, cards + deckCapacity, rng);
+        deal();
+    }
+
     // Play one turn of the game
     virtual void playTurn();
 
+    // Play one turn, letting strategy choose which playable card to play.
+    // Strategy is any type with int chooseCard(const TurnView&) returning a
+    // card id from view.playable; as a template parameter the call is bound
+    // at compile time. Pass a PlayerStrategy (unostrategy.h) for runtime
+    // selection. An invalid choice falls back to the lowest playable id.
+    template <class Strategy>
+    void playTurn(Strategy& strategy) {
+        TurnView view;
+        if (!beginTurn(view)) {
+            drawTurn();
+            return;
+        }
+        int card = strategy.chooseCard(view);
+        if (card < 0 || card >= Card::numIds || !(view.playable & (1ull << card))) {
+            card = Card::lowestCard(view.playable);
+        }
+        playCard(static_cast<uint8_t>(card));
+    }
+
     // Return true if game has a winner
     virtual bool isGameOver() const;
 
@@ -37,6 +181,64 @@ public:
 
     // Return current state as string
     virtual std::string getState() const;
+
+    // The same information as getState() as plain data
+    virtual GameSummary getSummary() const;
+
+    // Copy of the lifetime counters. Safe to call from any thread while
+    // another thread plays; each counter is read atomically, but the set
+    // is not one consistent snapshot.
+    virtual GameCounters getCounters() const;
+
+    // Time one turn in every sampleEvery (including the strategy's choice)
+    // into the latency histogram; 0 turns timing off
+    virtual void setTurnTiming(int sampleEvery);
+
+    // Copy the current position into a plain snapshot
+    virtual GameState saveState() const;
+
+    // Continue from a snapshot; turn and play counters restart at zero.
+    // The jump is not written to the event log.
+    virtual void loadState(const GameState& state);
+
+    // Mask of card ids that may be played on topCard
+    static uint64_t playableOn(uint8_t topCard);
+
+    // Return number of turns played so far
+    virtual int getTurnCount() const;
+
+    // Return number of cards of the given type played so far
+    virtual int getPlayCount(Card::Type type) const;
+
+    // Log every deal, move and win to sink in the binary format described
+    // in unolog.h; nullptr turns logging off. Events are batched and passed
+    // on when the batch fills, when a game is won and on flushEvents().
+    // The sink must outlive the game or be detached first.
+    virtual void setEventSink(EventSink* sink);
+
+    // Pass any batched events to the sink and flush it
+    virtual void flushEvents();
+
+private:
+    // Owned by the game; games share no state, so no lookup is needed
+    GameData* data;
+
+    // Clear hands and counters, refill the deck array in its unshuffled
+    // order and return it
+    uint8_t* resetDeck();
+
+    // Deal hands and the first discard from the top of the deck
+    void deal();
+
+    // Start a turn: fill view and return true if the current player can
+    // play; otherwise finish the turn with drawTurn
+    bool beginTurn(TurnView& view);
+
+    // Finish a turn by playing card from the current player's hand
+    void playCard(uint8_t card);
+
+    // Finish a turn by drawing, and playing the drawn card if it matches
+    void drawTurn();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef UNOBATCH_H
+#define UNOBATCH_H
+
+#include "uno.h"
+#include <cstdint>
+#include <vector>
+
+// Plays many UNO games with the default rule (play the lowest playable card
+// id), reproducing UNOGame::playTurn turn for turn. Games are played in
+// tiles that advance in lockstep: a tile keeps its games as struct-of-arrays
+// lanes and resolves one turn of every lane with straight-line mask
+// arithmetic, so the turn loop has no data-dependent branches and the
+// compiler vectorizes it. Finished games leave the tile as they win.
+class UNOBatch {
+public:
+    UNOBatch(int numGames, int numPlayers);
+
+    // Deal game i exactly as UNOGame::initialize(seeds[i]) does
+    void deal(const uint64_t* seeds);
+
+    // Play every game until it has a winner or has played maxTurns turns
+    void run(int maxTurns);
+
+    int size() const { return numGames; }
+    bool isFinished(int game) const { return winner[game] >= 0; }
+    int getWinner(int game) const { return winner[game]; }
+    int getTurnCount(int game) const { return turns[game]; }
+
+    // Position of one game, comparable with UNOGame::saveState
+    GameState saveState(int game) const { return states[game]; }
+
+private:
+    int numGames;
+    int numPlayers;
+    std::vector<GameState> states;   // Between runs, one snapshot per game
+    std::vector<int8_t> winner;      // -1 while running
+    std::vector<int> turns;
+};
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef UNOLOG_H
+#define UNOLOG_H
+
+#include "uno.h"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary event log for UNOGame (see UNOGame::setEventSink).
+//
+// Every event starts with one byte: bits 0-2 hold the type, bits 3-4 the
+// seat and bits 5-7 flags. The payload depends on the type:
+//   DEAL      8-byte little-endian seed for UNOGame::initialize(seed), or
+//             with deckFlag the 100 card ids of the shuffled deck; the
+//             seat field holds numPlayers - 1
+//   PLAY, SKIP, REVERSE, DRAW_TWO
+//             1 byte: the card id played
+//   DRAW      1 byte: the card id drawn, absent with emptyFlag.
+//             playedFlag: the drawn card matched and was played at once;
+//             forcedFlag: drawn because of the previous seat's Draw Two
+//   WIN       no payload; the seat emptied its hand
+// A turn is logged as one PLAY, SKIP, REVERSE, DRAW_TWO or unforced DRAW,
+// followed by its consequences (forced draws, win).
+struct GameEvent {
+    enum Type { DEAL, PLAY, DRAW, SKIP, REVERSE, DRAW_TWO, WIN };
+
+    static const uint8_t deckFlag = 0x20;     // DEAL
+    static const uint8_t playedFlag = 0x20;   // DRAW
+    static const uint8_t emptyFlag = 0x40;    // DRAW
+    static const uint8_t forcedFlag = 0x80;   // DRAW
+
+    // Largest encoded event: a DEAL with its deck
+    static const int maxSize = 1 + UNOGame::deckCapacity;
+
+    Type type;
+    int seat;               // Acting seat (DEAL: 0)
+    int numPlayers;         // DEAL only
+    uint8_t flags;
+    uint8_t card;           // Card played or drawn
+    uint64_t seed;          // Seeded DEAL
+    const uint8_t* deck;    // DEAL with deckFlag; points into the log
+};
+
+// Decode the event at data. Returns its size in bytes, or 0 if the bytes
+// are truncated or not a valid event.
+size_t decodeEvent(const uint8_t* data, size_t size, GameEvent& event);
+
+// Rebuild a game from the log: start from the DEAL event at offset, then
+// replay up to maxTurns turns by feeding the logged cards to
+// UNOGame::playTurn. On return offset is at the next DEAL (or the end of
+// the log). Returns false if the log is malformed or does not match the
+// rules, e.g. a logged card that was not playable.
+bool replayGame(const uint8_t* log, size_t size, size_t& offset, UNOGame& game,
+                int maxTurns = INT_MAX);
+
+// Receives encoded events. UNOGame batches events and passes them on in
+// chunks that always end on an event boundary.
+class EventSink {
+public:
+    virtual ~EventSink() {}
+    virtual void write(const uint8_t* data, size_t size) = 0;
+    virtual void flush() {}
+};
+
+// Keeps events in caller-provided memory for a consumer to drain with
+// read(). A chunk that does not fit is dropped whole and counted, so
+// what remains always decodes.
+class RingBufferSink : public EventSink {
+public:
+    // buffer must hold capacity bytes and outlive the sink
+    RingBufferSink(uint8_t* buffer, size_t capacity);
+
+    void write(const uint8_t* data, size_t size) override;
+
+    // Move up to max bytes, oldest first, into out; returns the count
+    size_t read(uint8_t* out, size_t max);
+
+    size_t size() const { return used; }
+    size_t capacity() const { return bufferSize; }
+    size_t droppedBytes() const { return dropped; }
+
+private:
+    uint8_t* buffer;
+    size_t bufferSize;
+    size_t start;      // Oldest byte
+    size_t used;
+    size_t dropped;
+};
+
+// Appends events to a file through a write buffer, so the file sees one
+// write call per bufferSize bytes
+class FileSink : public EventSink {
+public:
+    FileSink(const std::string& path, size_t bufferSize = 64 * 1024);
+    ~FileSink();
+
+    FileSink(const FileSink&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    void write(const uint8_t* data, size_t size) override;
+
+    // Write out buffered bytes
+    void flush() override;
+
+    // False once opening or writing the file has failed
+    bool ok() const { return fd >= 0 && !failed; }
+
+private:
+    int fd;
+    bool failed;
+    std::vector<uint8_t> pending;
+    size_t limit;
+};
+
+#endif
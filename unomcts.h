@@ -0,0 +1,67 @@
+#ifndef UNOMCTS_H
+#define UNOMCTS_H
+
+#include "uno.h"
+#include "rng.h"
+#include <vector>
+
+// Replace everything viewer cannot see with a random deal consistent with
+// it: the other seats' hands and the rest of the deck are pooled, shuffled
+// and dealt back with the same hand sizes. The viewer's hand, the top card
+// and the turn order are unchanged.
+void determinize(GameState& state, int viewer, Xoshiro256& rng);
+
+struct MctsOptions {
+    int iterations = 1000;        // Rollouts per decision
+    int maxRolloutTurns = 300;    // Longer rollouts go to the seat with fewest cards
+    double exploration = 0.7;     // UCB1 exploration constant
+    uint64_t seed = 1;
+};
+
+// Information-set Monte Carlo Tree Search player (single observer): every
+// iteration determinizes the hidden cards, walks the shared tree with UCB1
+// over the moves legal in that determinization, expands one node and plays
+// the rest of the game out with the default policy on a scratch game.
+// Use it as a strategy for the game it observes:
+//   MctsStrategy mcts(game);
+//   game.playTurn(mcts);
+class MctsStrategy {
+public:
+    MctsStrategy(const UNOGame& game, const MctsOptions& options = MctsOptions());
+
+    MctsStrategy(const MctsStrategy&) = delete;
+    MctsStrategy& operator=(const MctsStrategy&) = delete;
+
+    int chooseCard(const TurnView& view);
+
+    // Rollouts run so far, over all decisions
+    long long rollouts() const { return totalRollouts; }
+
+private:
+    // Tree node; children form a singly linked list through nextSibling
+    struct Node {
+        int firstChild;
+        int nextSibling;
+        int8_t action;       // Card played to reach this node, or drawAction
+        int8_t player;       // Seat that made that move
+        int visits;
+        int availability;    // Times this move was legal during selection
+        double wins;         // Wins for player
+    };
+
+    static const int8_t drawAction = -1;
+
+    const UNOGame& game;
+    MctsOptions options;
+    Xoshiro256 rng;
+    UNOGame scratch;
+    std::vector<Node> nodes;     // Reused between decisions
+    std::vector<int> path;
+    long long totalRollouts;
+
+    int addChild(int parent, int8_t action, int8_t player);
+    int findChild(int parent, int8_t action) const;
+    int rollout();
+};
+
+#endif
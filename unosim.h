@@ -0,0 +1,57 @@
+#ifndef UNOSIM_H
+#define UNOSIM_H
+
+#include "uno.h"
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Aggregated outcome of a batch of simulated UNO games
+struct SimulationResult {
+    long long games;                       // Games played
+    long long unfinished;                  // Games stopped at the turn limit
+    long long totalTurns;
+    std::vector<long long> wins;           // Wins per seat
+    std::vector<long long> lengthHistogram; // Finished games by length, bucketWidth turns per bucket
+    int bucketWidth;
+    long long skips;                       // Action cards played
+    long long reverses;
+    long long drawTwos;
+
+    // Merge another partial result into this one
+    void add(const SimulationResult& other);
+};
+
+// Games created up front for simulation workers. A worker borrows one,
+// calls reset() for every game it plays and hands it back, so memory stays
+// flat however many games are run.
+class GamePool {
+public:
+    GamePool(int size, int numPlayers = UNOGame::maxPlayers);
+    ~GamePool();
+
+    GamePool(const GamePool&) = delete;
+    GamePool& operator=(const GamePool&) = delete;
+
+    // Borrow a game, or nullptr when every game is in use
+    UNOGame* acquire();
+
+    // Return a borrowed game to the pool
+    void release(UNOGame* game);
+
+    int size() const;
+
+private:
+    std::vector<UNOGame*> games;
+    std::vector<UNOGame*> available;
+    std::mutex lock;
+};
+
+// Play numGames complete games of UNOGame with numPlayers seats across
+// numThreads threads (0 = all cores). Game i is shuffled with a seed derived
+// only from masterSeed and i, so results do not depend on the thread count.
+// Games still running after maxTurns turns are counted as unfinished.
+SimulationResult simulateGames(int numPlayers, long long numGames, uint64_t masterSeed,
+                               int numThreads = 0, int maxTurns = 2000);
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef UNOSTRATEGY_H
+#define UNOSTRATEGY_H
+
+#include "uno.h"
+#include <vector>
+
+// Card selection policies for UNOGame::playTurn(Strategy&). Each strategy
+// gets a TurnView and returns the id of one card in view.playable.
+
+// The original rule: the lowest playable card id
+struct FirstPlayableStrategy {
+    int chooseCard(const TurnView& view) {
+        return Card::lowestCard(view.playable);
+    }
+};
+
+// Greedy: play Skip, Reverse or Draw Two whenever possible
+struct ActionFirstStrategy {
+    int chooseCard(const TurnView& view) {
+        uint64_t actions = view.playable & Card::actionCards;
+        return Card::lowestCard(actions ? actions : view.playable);
+    }
+};
+
+// Play a card of the color we hold most of, keeping our options open
+struct ColorCountStrategy {
+    int chooseCard(const TurnView& view) {
+        int bestCount = -1;
+        uint64_t best = 0;
+        for (int color = 0; color < 4; color++) {
+            uint64_t mask = Card::cardsOfColor(color);
+            if (!(view.playable & mask)) continue;
+            int count = __builtin_popcountll(view.hand & mask) +
+                        __builtin_popcountll(view.handDoubles & mask);
+            if (count > bestCount) {
+                bestCount = count;
+                best = view.playable & mask;
+            }
+        }
+        return Card::lowestCard(best);
+    }
+};
+
+// Learned policy: a score per card id (for example trained offline), and
+// the playable card with the highest score is played
+struct WeightedStrategy {
+    float weights[Card::numIds];
+
+    WeightedStrategy() {
+        for (int i = 0; i < Card::numIds; i++) {
+            weights[i] = 0.0f;
+        }
+    }
+
+    explicit WeightedStrategy(const std::vector<float>& w) : WeightedStrategy() {
+        for (int i = 0; i < Card::numIds && i < static_cast<int>(w.size()); i++) {
+            weights[i] = w[i];
+        }
+    }
+
+    int chooseCard(const TurnView& view) {
+        int best = Card::lowestCard(view.playable);
+        for (uint64_t cards = view.playable & (view.playable - 1); cards; cards &= cards - 1) {
+            int id = Card::lowestCard(cards);
+            if (weights[id] > weights[best]) {
+                best = id;
+            }
+        }
+        return best;
+    }
+};
+
+// Type-erased strategy for configuration-driven setups, where the policy
+// is picked at runtime. Costs one virtual call per turn.
+class PlayerStrategy {
+public:
+    virtual ~PlayerStrategy() {}
+    virtual int chooseCard(const TurnView& view) = 0;
+};
+
+// Wrap any compile-time strategy as a PlayerStrategy
+template <class Strategy>
+class StrategyAdapter : public PlayerStrategy {
+public:
+    StrategyAdapter() {}
+    explicit StrategyAdapter(const Strategy& s) : strategy(s) {}
+
+    int chooseCard(const TurnView& view) override {
+        return strategy.chooseCard(view);
+    }
+
+private:
+    Strategy strategy;
+};
+
+// One runtime strategy per seat; seats without one use the lowest playable card
+class SeatStrategies {
+public:
+    SeatStrategies() {
+        for (int i = 0; i < UNOGame::maxPlayers; i++) {
+            seats[i] = nullptr;
+        }
+    }
+
+    void setSeat(int seat, PlayerStrategy* strategy) {
+        seats[seat] = strategy;
+    }
+
+    int chooseCard(const TurnView& view) {
+        PlayerStrategy* strategy = seats[view.player];
+        return strategy ? strategy->chooseCard(view) : Card::lowestCard(view.playable);
+    }
+
+private:
+    PlayerStrategy* seats[UNOGame::maxPlayers];
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef UNOTOURNAMENT_H
+#define UNOTOURNAMENT_H
+
+#include "uno.h"
+#include "unostrategy.h"
+#include <cstdint>
+#include <vector>
+
+struct TournamentOptions {
+    int entrants = 400000;
+    int seatsPerTable = 4;        // 2-4; some tables get fewer so nobody sits alone
+    int numThreads = 0;           // Workers; 0 = all cores
+    int maxTurns = 2000;          // Then the seat with the fewest cards wins
+    uint64_t seed = 1;
+    int latencySampleEvery = 16;  // Time one turn in this many
+    int tablesPerWorker = 8;      // Tables in play at once per worker
+};
+
+// A decision requested from an asynchronous seat
+struct MoveRequest {
+    int table;
+    int entrant;
+    TurnView view;                // view.playable is never 0
+};
+
+class Tournament;
+
+// A seat whose decisions arrive later, from a person or a remote bot. The
+// table waits without holding a worker; other tables keep playing.
+class AsyncSeat {
+public:
+    virtual ~AsyncSeat() {}
+
+    // Called on a worker thread when the seat must choose a card. Return
+    // at once and deliver the choice, from any thread, with
+    // Tournament::submitMove(request.table, card).
+    virtual void requestMove(Tournament& tournament, const MoveRequest& request) = 0;
+};
+
+struct TournamentResult {
+    int champion;                       // Entrant who won the final table
+    int rounds;
+    long long tables;
+    long long unfinishedTables;         // Decided on cards left at maxTurns
+    long long turns;
+    double seconds;
+    double turnsPerSecond;
+
+    // Sampled per-turn times in ns: running the turn, and waiting in a
+    // queue since the table's previous turn (fairness under load)
+    double turnP50, turnP99, turnP999, turnMax;
+    double waitP50, waitP99, waitP999, waitMax;
+
+    std::vector<long long> tablesPerRound;
+    std::vector<uint8_t> roundReached;  // Per entrant: rounds won
+};
+
+// Single-elimination UNO tournament. Entrants are seated at tables of
+// seatsPerTable; each table's winner moves up to the next round's table as
+// soon as it is decided, and that table is dealt once all its seats are
+// filled. Tables are scheduled one turn at a time on a fixed pool of
+// workers, each with its own FIFO queue of tables that idle workers steal
+// from, so every ready table gets a turn in order and a slow turn holds up
+// only the table it belongs to. First-round tables are dealt only as
+// earlier ones finish, keeping about tablesPerWorker tables per worker in
+// play (plus any waiting for an AsyncSeat), so memory grows with the
+// worker count rather than the entrant count. Every table is dealt from a
+// seed derived from the tournament seed and its position in the bracket,
+// so results do not depend on the thread count.
+class Tournament {
+public:
+    explicit Tournament(const TournamentOptions& options = TournamentOptions());
+    ~Tournament();
+
+    Tournament(const Tournament&) = delete;
+    Tournament& operator=(const Tournament&) = delete;
+
+    // Seat policy of an entrant; entrants without one play the lowest
+    // playable card. Strategies are shared by every table the entrant
+    // plays at, possibly on several threads, and must be safe for that.
+    void setStrategy(int entrant, PlayerStrategy* strategy);
+    void setAsyncSeat(int entrant, AsyncSeat* seat);
+
+    // Deliver an AsyncSeat's card; returns false if the table was not
+    // waiting for one. An unplayable card falls back to the lowest
+    // playable one. Safe from any thread.
+    bool submitMove(int table, int card);
+
+    // Play the whole tournament on the worker pool and block until done
+    TournamentResult run();
+
+private:
+    class TournamentData* data;
+};
+
+#endif